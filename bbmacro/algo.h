@@ -0,0 +1,261 @@
+#ifndef BBMACRO_ALGO_H_
+#define BBMACRO_ALGO_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <string.h>
+#include <bbmacro/static.h>
+#include <bbmacro/vector.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * Algorithms appendix to the Backward Vector: sorting, searching
+ * and removing the repeated elements.
+ * 1. LESS(value1, value2) returns non-zero if the first element goes first.
+ *    It may be a macro, so the comparisons are inlined
+ *    (unlike the calls of a comparator by `qsort()` and `bsearch()`).
+ * 2. The `sort` procedure is an introsort: a quicksort with the median
+ *    of three, switching to the heapsort on bad pivots and to the
+ *    insertion sort on short ranges. It is not stable.
+ * 3. The searches are branchless binary searches: the only branch is
+ *    the loop, so there are no mispredictions on random keys.
+ * 4. The radix sort (a separate appendix) orders the elements by an
+ *    unsigned integer key. It is stable and needs a temporary array.
+ * 5. Only the core procedures are used, so any memory management will do.
+ */
+
+/*
+ * How to call the macro?
+ * #define item_less(item1, item2) ((item1).id < (item2).id)
+ * #define item_key(item) ((unsigned long)(item).id)
+ * BVECTOR_DEFAULT(items, struct item);
+ * BVECTOR_ALGO(items, struct item, item_less);
+ * BVECTOR_RADIX(items, struct item, item_key);
+ * For a signed key, flip the sign bit of it, e.g. for `int`:
+ * #define int_key(num) ((unsigned long)(unsigned)(num) ^ 0x80000000UL)
+ */
+
+/*
+ * How to use the procedures?
+ * items_sort(&v);
+ * found = items_search(item, &v);
+ * items_unique(&v);
+ * tmp = malloc(sizeof(struct item) * v.len);
+ * items_radixsort(tmp, &v);
+ */
+
+/* Ranges shorter than this are sorted by insertion. */
+#define BBALGO_INSERTION 16
+
+/****************************************
+ * Algorithms interface.
+ ****************************************/
+
+/*
+ * Algorithms procedures.
+ * The searches require the vector to be sorted. The `lowerbound`
+ * procedure returns the position of the first element not less than
+ * the value, the `upperbound` procedure -- of the first one greater.
+ * The `search` procedure returns an element equal to the value or NULL.
+ * The `unique` procedure keeps the first of equal adjacent elements.
+ */
+#define BVECTOR_ALGO_DECLARATIONS(BV, ELEMENT, PREFIX) \
+\
+PREFIX void BV##_sort(struct BV *bv); \
+PREFIX size_t BV##_lowerbound(ELEMENT value, struct BV *bv); \
+PREFIX size_t BV##_upperbound(ELEMENT value, struct BV *bv); \
+PREFIX ELEMENT *BV##_search(ELEMENT value, struct BV *bv); \
+PREFIX void BV##_unique(struct BV *bv); \
+bbstatic_semicolon
+
+/*
+ * Radix sort procedure.
+ * The temporary array must hold `len` elements.
+ */
+#define BVECTOR_RADIX_DECLARATIONS(BV, ELEMENT, PREFIX) \
+\
+PREFIX void BV##_radixsort(ELEMENT *tmp, struct BV *bv); \
+bbstatic_semicolon
+
+/****************************************
+ * Algorithms implementation.
+ ****************************************/
+
+/* Algorithms procedures. */
+#define BVECTOR_ALGO_IMPLEMENTATION(BV, ELEMENT, LESS) \
+\
+static BBUNUSED void BV##_insertion_(ELEMENT *at, size_t len) \
+{	size_t num; \
+	for (num = 1; num < len; num++) { \
+		ELEMENT value = at[num]; \
+		size_t pos = num; \
+		for (; pos > 0 && LESS(value, at[pos - 1]); pos--) \
+			at[pos] = at[pos - 1]; \
+		at[pos] = value; \
+	} \
+} \
+static BBUNUSED void BV##_sift_(ELEMENT *at, size_t num, size_t len) \
+{	ELEMENT value = at[num]; \
+	size_t child; \
+	while ((child = num * 2 + 1) < len) { \
+		if (child + 1 < len && LESS(at[child], at[child + 1])) \
+			child++; \
+		if (!(LESS(value, at[child]))) \
+			break; \
+		at[num] = at[child]; \
+		num = child; \
+	} \
+	at[num] = value; \
+} \
+static BBUNUSED void BV##_heapsort_(ELEMENT *at, size_t len) \
+{	size_t num = len / 2; \
+	while (num-- > 0) \
+		BV##_sift_(at, num, len); \
+	while (len-- > 1) { \
+		ELEMENT value = at[len]; \
+		at[len] = at[0]; \
+		at[0] = value; \
+		BV##_sift_(at, 0, len); \
+	} \
+} \
+static BBUNUSED void BV##_introsort_(ELEMENT *at, size_t len, int depth) \
+{	while (len > BBALGO_INSERTION) { \
+		size_t mid = len / 2, left = 0, right = len - 1; \
+		ELEMENT pivot, value; \
+		if (depth-- == 0) { \
+			BV##_heapsort_(at, len); \
+			return; \
+		} \
+		/* The median of three; the ends stop the scans below. */ \
+		if (LESS(at[mid], at[0])) { \
+			value = at[mid]; at[mid] = at[0]; at[0] = value; \
+		} \
+		if (LESS(at[len - 1], at[mid])) { \
+			value = at[mid]; at[mid] = at[len - 1]; at[len - 1] = value; \
+			if (LESS(at[mid], at[0])) { \
+				value = at[mid]; at[mid] = at[0]; at[0] = value; \
+			} \
+		} \
+		pivot = at[mid]; \
+		for (;;) { \
+			do \
+				left++; \
+			while (LESS(at[left], pivot)); \
+			do \
+				right--; \
+			while (LESS(pivot, at[right])); \
+			if (left >= right) \
+				break; \
+			value = at[left]; at[left] = at[right]; at[right] = value; \
+		} \
+		/* Recurse into the shorter part, loop over the longer one. */ \
+		if (left < len - left) { \
+			BV##_introsort_(at, left, depth); \
+			at += left; \
+			len -= left; \
+		} else { \
+			BV##_introsort_(at + left, len - left, depth); \
+			len = left; \
+		} \
+	} \
+	BV##_insertion_(at, len); \
+} \
+void BV##_sort(struct BV *bv) \
+{	size_t len; \
+	int depth = 0; \
+	for (len = bv->len; len > 1; len >>= 1) \
+		depth += 2; \
+	BV##_introsort_(bv->at, bv->len, depth); \
+} \
+size_t BV##_lowerbound(ELEMENT value, struct BV *bv) \
+{	ELEMENT *base = bv->at; \
+	size_t len = bv->len; \
+	if (len == 0) \
+		return 0; \
+	while (len > 1) { \
+		size_t half = len / 2; \
+		base = LESS(base[half], value) ? base + half : base; \
+		len -= half; \
+	} \
+	return (size_t)(base - bv->at) + (LESS(*base, value) ? 1 : 0); \
+} \
+size_t BV##_upperbound(ELEMENT value, struct BV *bv) \
+{	ELEMENT *base = bv->at; \
+	size_t len = bv->len; \
+	if (len == 0) \
+		return 0; \
+	while (len > 1) { \
+		size_t half = len / 2; \
+		base = LESS(value, base[half]) ? base : base + half; \
+		len -= half; \
+	} \
+	return (size_t)(base - bv->at) + (LESS(value, *base) ? 0 : 1); \
+} \
+ELEMENT *BV##_search(ELEMENT value, struct BV *bv) \
+{	size_t pos = BV##_lowerbound(value, bv); \
+	if (pos == bv->len || LESS(value, bv->at[pos])) \
+		return NULL; \
+	return &bv->at[pos]; \
+} \
+void BV##_unique(struct BV *bv) \
+{	size_t num, len = 0; \
+	for (num = 0; num < bv->len; num++) \
+		if (len == 0 || LESS(bv->at[len - 1], bv->at[num]) || \
+			LESS(bv->at[num], bv->at[len - 1])) \
+			bv->at[len++] = bv->at[num]; \
+	bv->len = len; \
+} \
+bbstatic_semicolon
+
+/*
+ * Radix sort procedure.
+ * KEY(value) returns the key as an unsigned long. The key is sorted byte
+ * by byte, the least significant first; the bytes equal in all the keys
+ * (e.g. the high bytes of small keys) are skipped.
+ */
+#define BVECTOR_RADIX_IMPLEMENTATION(BV, ELEMENT, KEY) \
+\
+void BV##_radixsort(ELEMENT *tmp, struct BV *bv) \
+{	size_t count[sizeof(unsigned long)][256]; \
+	ELEMENT *src = bv->at, *dst = tmp, *swap; \
+	size_t num, byte, len = bv->len; \
+	if (len < 2) \
+		return; \
+	memset(count, 0, sizeof(count)); \
+	for (num = 0; num < len; num++) { \
+		unsigned long key = KEY(src[num]); \
+		for (byte = 0; byte < sizeof(unsigned long); byte++) \
+			count[byte][(key >> byte * 8) & 0xFF]++; \
+	} \
+	for (byte = 0; byte < sizeof(unsigned long); byte++) { \
+		size_t *pos = count[byte], sum = 0; \
+		if (pos[(KEY(src[0]) >> byte * 8) & 0xFF] == len) \
+			continue; \
+		for (num = 0; num < 256; num++) { \
+			size_t cnt = pos[num]; \
+			pos[num] = sum; \
+			sum += cnt; \
+		} \
+		for (num = 0; num < len; num++) \
+			dst[pos[(KEY(src[num]) >> byte * 8) & 0xFF]++] = src[num]; \
+		swap = src; \
+		src = dst; \
+		dst = swap; \
+	} \
+	if (src != bv->at) \
+		memcpy(bv->at, src, sizeof(ELEMENT) * len); \
+} \
+bbstatic_semicolon
+
+/* Algorithms full. */
+#define BVECTOR_ALGO(BV, ELEMENT, LESS) \
+	BVECTOR_ALGO_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	BVECTOR_ALGO_IMPLEMENTATION(BV, ELEMENT, LESS)
+
+/* Radix sort full. */
+#define BVECTOR_RADIX(BV, ELEMENT, KEY) \
+	BVECTOR_RADIX_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	BVECTOR_RADIX_IMPLEMENTATION(BV, ELEMENT, KEY)
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef BBMACRO_ATOMIC_H_
+#define BBMACRO_ATOMIC_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__) /* C11. */
+#include <stdatomic.h>
+#endif
+#undef NOINCLUDE
+#endif
+
+/*
+ * Portable atomic operations.
+ * 1. C11 atomics are used where available. Otherwise (e.g. with -std=c89)
+ *    the GCC builtins are used, which are known to GCC and Clang.
+ * 2. An atomic variable is declared as `BBATOMIC(type) name`
+ *    and is accessed with the `bbatomic_*` macros only.
+ * 3. The memory order is always explicit: one of BBATOMIC_RELAXED,
+ *    BBATOMIC_ACQUIRE, BBATOMIC_RELEASE, BBATOMIC_ACQ_REL, BBATOMIC_SEQ_CST.
+ * 4. The compare-and-swap macros take a pointer to the expected value,
+ *    update it on failure and return non-zero on success.
+ */
+
+/* Size of a cache line (the data of different threads is padded by it). */
+#ifndef BBCACHELINE
+#  define BBCACHELINE 64
+#endif
+
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__) /* C11. */
+
+#  define BBATOMIC(TYPE) _Atomic(TYPE)
+
+#  define BBATOMIC_RELAXED memory_order_relaxed
+#  define BBATOMIC_ACQUIRE memory_order_acquire
+#  define BBATOMIC_RELEASE memory_order_release
+#  define BBATOMIC_ACQ_REL memory_order_acq_rel
+#  define BBATOMIC_SEQ_CST memory_order_seq_cst
+
+#  define bbatomic_load(ptr, order) \
+	atomic_load_explicit((ptr), (order))
+#  define bbatomic_store(ptr, value, order) \
+	atomic_store_explicit((ptr), (value), (order))
+#  define bbatomic_exchange(ptr, value, order) \
+	atomic_exchange_explicit((ptr), (value), (order))
+#  define bbatomic_fetch_add(ptr, value, order) \
+	atomic_fetch_add_explicit((ptr), (value), (order))
+#  define bbatomic_fetch_sub(ptr, value, order) \
+	atomic_fetch_sub_explicit((ptr), (value), (order))
+#  define bbatomic_cas(ptr, expected, desired, order) \
+	atomic_compare_exchange_strong_explicit((ptr), (expected), (desired), \
+		(order), memory_order_relaxed)
+#  define bbatomic_cas_weak(ptr, expected, desired, order) \
+	atomic_compare_exchange_weak_explicit((ptr), (expected), (desired), \
+		(order), memory_order_relaxed)
+#  define bbatomic_fence(order) \
+	atomic_thread_fence((order))
+
+#elif defined(__ATOMIC_RELAXED) /* GCC 4.7 or Clang. */
+
+#  define BBATOMIC(TYPE) TYPE
+
+#  define BBATOMIC_RELAXED __ATOMIC_RELAXED
+#  define BBATOMIC_ACQUIRE __ATOMIC_ACQUIRE
+#  define BBATOMIC_RELEASE __ATOMIC_RELEASE
+#  define BBATOMIC_ACQ_REL __ATOMIC_ACQ_REL
+#  define BBATOMIC_SEQ_CST __ATOMIC_SEQ_CST
+
+#  define bbatomic_load(ptr, order) \
+	__atomic_load_n((ptr), (order))
+#  define bbatomic_store(ptr, value, order) \
+	__atomic_store_n((ptr), (value), (order))
+#  define bbatomic_exchange(ptr, value, order) \
+	__atomic_exchange_n((ptr), (value), (order))
+#  define bbatomic_fetch_add(ptr, value, order) \
+	__atomic_fetch_add((ptr), (value), (order))
+#  define bbatomic_fetch_sub(ptr, value, order) \
+	__atomic_fetch_sub((ptr), (value), (order))
+#  define bbatomic_cas(ptr, expected, desired, order) \
+	__atomic_compare_exchange_n((ptr), (expected), (desired), 0, \
+		(order), __ATOMIC_RELAXED)
+#  define bbatomic_cas_weak(ptr, expected, desired, order) \
+	__atomic_compare_exchange_n((ptr), (expected), (desired), 1, \
+		(order), __ATOMIC_RELAXED)
+#  define bbatomic_fence(order) \
+	__atomic_thread_fence((order))
+
+#else
+#  error "bbmacro/atomic.h: neither C11 atomics nor GCC builtins available"
+#endif
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef BBMACRO_DEQUE_H_
+#define BBMACRO_DEQUE_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <stddef.h>
+#include <bbmacro/static.h>
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__) /* C11. */
+#include <stdatomic.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/atomic.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * Work-stealing deque (Chase-Lev) for task scheduling.
+ * 1. The owner thread pushes and pops elements at the back;
+ *    any other thread may steal elements from the front.
+ * 2. The elements live in a circular array of power-of-two capacity.
+ *    A full array is replaced with a doubled one; the replaced arrays
+ *    are kept (thieves may still read them) until the deque is finished.
+ * 3. A thief copies an element before claiming it and drops the copy
+ *    if another thread wins, so the elements should be small
+ *    (e.g. pointers to tasks).
+ * 4. Core procedures provide manual memory management only
+ *    (then `push` fails on a full deque).
+ * 5. Note the deque itself is always the last argument of a procedure.
+ */
+
+/*
+ * How to use the deque?
+ * WSDEQUE_DEFAULT(mydeque, struct task *);
+ * struct mydeque d;
+ * mydeque_ainit(64, &d);
+ * ... owner thread ...
+ * mydeque_apush(task, &d);
+ * if (!mydeque_pop(&task, &d))
+ *     ... run the task ...
+ * ... other threads ...
+ * if (!mydeque_steal(&task, &d))
+ *     ... run the task ...
+ * ... after all threads are done ...
+ * mydeque_afini(&d);
+ */
+
+/****************************************
+ * Work-Stealing Deque interface.
+ ****************************************/
+
+/* Work-Stealing Deque structure. */
+#define WSDEQUE_STRUCT(DQ, ELEMENT) \
+\
+struct DQ##_array { \
+	size_t cap; /* Capacity (a power of two). */ \
+	ELEMENT *at; /* Beginning of memory. */ \
+	struct DQ##_array *prev; /* Array replaced by this one. */ \
+}; \
+struct DQ { \
+	BBATOMIC(struct DQ##_array *) array; /* Current array. */ \
+	struct DQ##_array base; /* First array. */ \
+	char pad1[BBCACHELINE]; \
+	BBATOMIC(size_t) top; /* Position to steal. */ \
+	char pad2[BBCACHELINE]; \
+	BBATOMIC(size_t) bottom; /* Position to push (owned). */ \
+	char pad3[BBCACHELINE]; \
+}
+
+/*
+ * Work-Stealing Deque core procedures.
+ * Only the owner thread may call `push` and `pop`.
+ * The procedures return 0 on success and -1 if the deque is full (or
+ * empty). The `steal` procedure also returns -1 if another thread has
+ * taken the element first, so a retry may succeed.
+ * The `len` procedure returns a snapshot.
+ */
+#define WSDEQUE_CORE_DECLARATIONS(DQ, ELEMENT, PREFIX) \
+\
+PREFIX void DQ##_init(ELEMENT *array, size_t cap, struct DQ *dq); \
+PREFIX ELEMENT *DQ##_fini(struct DQ *dq); \
+PREFIX size_t DQ##_len(struct DQ *dq); \
+\
+PREFIX int DQ##_push(ELEMENT value, struct DQ *dq); \
+PREFIX int DQ##_pop(ELEMENT *value, struct DQ *dq); \
+PREFIX int DQ##_steal(ELEMENT *value, struct DQ *dq); \
+bbstatic_semicolon
+
+/*
+ * Work-Stealing Deque automatic memory management appendix.
+ * The capacity is rounded up to a power of two.
+ */
+#define WSDEQUE_AUTO_DECLARATIONS(DQ, ELEMENT, PREFIX) \
+\
+PREFIX void DQ##_ainit(size_t cap, struct DQ *dq); \
+PREFIX void DQ##_afini(struct DQ *dq); \
+PREFIX void DQ##_apush(ELEMENT value, struct DQ *dq); \
+bbstatic_semicolon
+
+/* Work-Stealing Deque automatic memory management procedures. */
+#define WSDEQUE_DECLARATIONS(DQ, ELEMENT, PREFIX) \
+	WSDEQUE_CORE_DECLARATIONS(DQ, ELEMENT, PREFIX); \
+	WSDEQUE_AUTO_DECLARATIONS(DQ, ELEMENT, PREFIX)
+
+/* Work-Stealing Deque core interface. */
+#define WSDEQUE_CORE_INTERFACE(DQ, ELEMENT, PREFIX) \
+	WSDEQUE_STRUCT(DQ, ELEMENT); \
+	WSDEQUE_CORE_DECLARATIONS(DQ, ELEMENT, PREFIX)
+
+/* Work-Stealing Deque automatic memory management interface. */
+#define WSDEQUE_INTERFACE(DQ, ELEMENT, PREFIX) \
+	WSDEQUE_STRUCT(DQ, ELEMENT); \
+	WSDEQUE_DECLARATIONS(DQ, ELEMENT, PREFIX)
+
+/****************************************
+ * Work-Stealing Deque implementation.
+ ****************************************/
+
+/* Work-Stealing Deque core procedures. */
+#define WSDEQUE_CORE_IMPLEMENTATION(DQ, ELEMENT) \
+\
+void DQ##_init(ELEMENT *array, size_t cap, struct DQ *dq) \
+{	dq->base.cap = cap; \
+	dq->base.at = array; \
+	dq->base.prev = NULL; \
+	bbatomic_store(&dq->array, &dq->base, BBATOMIC_RELAXED); \
+	bbatomic_store(&dq->top, 0, BBATOMIC_RELAXED); \
+	bbatomic_store(&dq->bottom, 0, BBATOMIC_RELAXED); \
+} \
+ELEMENT *DQ##_fini(struct DQ *dq) \
+{	return dq->base.at; \
+} \
+size_t DQ##_len(struct DQ *dq) \
+{	size_t top = bbatomic_load(&dq->top, BBATOMIC_ACQUIRE); \
+	size_t bottom = bbatomic_load(&dq->bottom, BBATOMIC_ACQUIRE); \
+	return (ptrdiff_t)(bottom - top) > 0 ? bottom - top : 0; \
+} \
+int DQ##_push(ELEMENT value, struct DQ *dq) \
+{	size_t bottom = bbatomic_load(&dq->bottom, BBATOMIC_RELAXED); \
+	size_t top = bbatomic_load(&dq->top, BBATOMIC_ACQUIRE); \
+	struct DQ##_array *array = bbatomic_load(&dq->array, BBATOMIC_RELAXED); \
+	if (bottom - top >= array->cap) \
+		return -1; \
+	array->at[bottom & (array->cap - 1)] = value; \
+	bbatomic_fence(BBATOMIC_RELEASE); \
+	bbatomic_store(&dq->bottom, bottom + 1, BBATOMIC_RELAXED); \
+	return 0; \
+} \
+int DQ##_pop(ELEMENT *value, struct DQ *dq) \
+{	size_t bottom = bbatomic_load(&dq->bottom, BBATOMIC_RELAXED) - 1; \
+	struct DQ##_array *array = bbatomic_load(&dq->array, BBATOMIC_RELAXED); \
+	size_t top; \
+	ELEMENT copy; \
+	bbatomic_store(&dq->bottom, bottom, BBATOMIC_RELAXED); \
+	bbatomic_fence(BBATOMIC_SEQ_CST); \
+	top = bbatomic_load(&dq->top, BBATOMIC_RELAXED); \
+	if ((ptrdiff_t)(bottom - top) < 0) { \
+		bbatomic_store(&dq->bottom, bottom + 1, BBATOMIC_RELAXED); \
+		return -1; \
+	} \
+	copy = array->at[bottom & (array->cap - 1)]; \
+	if (bottom == top) { /* The last element may be stolen meanwhile. */ \
+		int won = bbatomic_cas(&dq->top, &top, top + 1, \
+			BBATOMIC_SEQ_CST); \
+		bbatomic_store(&dq->bottom, bottom + 1, BBATOMIC_RELAXED); \
+		if (!won) \
+			return -1; \
+	} \
+	*value = copy; \
+	return 0; \
+} \
+int DQ##_steal(ELEMENT *value, struct DQ *dq) \
+{	size_t top = bbatomic_load(&dq->top, BBATOMIC_ACQUIRE); \
+	size_t bottom; \
+	struct DQ##_array *array; \
+	ELEMENT copy; \
+	bbatomic_fence(BBATOMIC_SEQ_CST); \
+	bottom = bbatomic_load(&dq->bottom, BBATOMIC_ACQUIRE); \
+	if ((ptrdiff_t)(bottom - top) <= 0) \
+		return -1; \
+	array = bbatomic_load(&dq->array, BBATOMIC_ACQUIRE); \
+	copy = array->at[top & (array->cap - 1)]; \
+	if (!bbatomic_cas(&dq->top, &top, top + 1, BBATOMIC_SEQ_CST)) \
+		return -1; \
+	*value = copy; \
+	return 0; \
+} \
+bbstatic_semicolon
+
+/*
+ * Work-Stealing Deque automatic memory management appendix.
+ * The arrays are doubled; the replaced ones are freed by `afini`.
+ */
+#define WSDEQUE_AUTO_IMPLEMENTATION(DQ, ELEMENT, ALLOC, FREE) \
+\
+void DQ##_ainit(size_t cap, struct DQ *dq) \
+{	cap = bbvector_pow2(cap ? cap : 1); \
+	DQ##_init(ALLOC(cap, sizeof(ELEMENT)), cap, dq); \
+} \
+void DQ##_afini(struct DQ *dq) \
+{	struct DQ##_array *array = bbatomic_load(&dq->array, BBATOMIC_RELAXED); \
+	while (array != &dq->base) { \
+		struct DQ##_array *prev = array->prev; \
+		FREE(array->at); \
+		FREE(array); \
+		array = prev; \
+	} \
+	FREE(DQ##_fini(dq)); \
+} \
+void DQ##_apush(ELEMENT value, struct DQ *dq) \
+{	if (DQ##_push(value, dq)) { \
+		struct DQ##_array *old = bbatomic_load(&dq->array, \
+			BBATOMIC_RELAXED); \
+		struct DQ##_array *array = ALLOC(1, sizeof(*array)); \
+		size_t top = bbatomic_load(&dq->top, BBATOMIC_ACQUIRE); \
+		size_t bottom = bbatomic_load(&dq->bottom, BBATOMIC_RELAXED); \
+		array->cap = old->cap * 2; \
+		array->at = ALLOC(array->cap, sizeof(ELEMENT)); \
+		array->prev = old; \
+		for (; top != bottom; top++) \
+			array->at[top & (array->cap - 1)] = \
+				old->at[top & (old->cap - 1)]; \
+		bbatomic_store(&dq->array, array, BBATOMIC_RELEASE); \
+		DQ##_push(value, dq); \
+	} \
+} \
+bbstatic_semicolon
+
+/* Work-Stealing Deque automatic memory management procedures. */
+#define WSDEQUE_IMPLEMENTATION(DQ, ELEMENT, ALLOC, FREE) \
+	WSDEQUE_CORE_IMPLEMENTATION(DQ, ELEMENT); \
+	WSDEQUE_AUTO_IMPLEMENTATION(DQ, ELEMENT, ALLOC, FREE)
+
+/* Work-Stealing Deque core full. */
+#define WSDEQUE_CORE(DQ, ELEMENT) \
+	WSDEQUE_CORE_INTERFACE(DQ, ELEMENT, static BBUNUSED); \
+	WSDEQUE_CORE_IMPLEMENTATION(DQ, ELEMENT)
+
+/* Work-Stealing Deque automatic memory management full. */
+#define WSDEQUE(DQ, ELEMENT, ALLOC, FREE) \
+	WSDEQUE_INTERFACE(DQ, ELEMENT, static BBUNUSED); \
+	WSDEQUE_IMPLEMENTATION(DQ, ELEMENT, ALLOC, FREE)
+
+#endif
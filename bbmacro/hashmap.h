@@ -0,0 +1,676 @@
+#ifndef BBMACRO_HASHMAP_H_
+#define BBMACRO_HASHMAP_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <string.h>
+#include <limits.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#undef NOINCLUDE
+#endif
+
+/*
+ * Hash map and hash set data structures (open addressing with control bytes).
+ * 1. Every slot has a control byte: either empty, or deleted, or full with
+ *    7 bits of the key hash. A lookup scans the control bytes of a group
+ *    of slots at once and compares the keys only where the bits match.
+ * 2. The capacity is a power of two (at least BBHASH_GROUP) or zero.
+ *    At most 7/8 of the slots are in use.
+ * 3. Core procedures provide manual memory management only.
+ * 4. Structure members are a read-only part of the interface.
+ * 5. Note the map itself is always the last argument of a procedure.
+ */
+
+/*
+ * How to call the macro?
+ * The same way as the vector macros (see `vector.h`), but with
+ * the key type, the value type and the key procedures:
+ * HASH(key) returns `size_t`, EQ(key1, key2) returns non-zero for equal keys.
+ * Both may be macros. Example:
+ * #define int_hash(key) ((size_t)(key))
+ * #define int_eq(key1, key2) ((key1) == (key2))
+ * HASHMAP_DEFAULT(mymap, int, double, int_hash, int_eq);
+ * HASHSET_DEFAULT(myset, int, int_hash, int_eq);
+ */
+
+/*
+ * How to use the map?
+ * struct mymap m;
+ * struct mymap_slot *slot;
+ * size_t pos = 0;
+ * mymap_ainit(0, &m);
+ * mymap_aset(1, 0.5, &m);
+ * *mymap_aput(2, &m) = 0.25;
+ * if (mymap_get(2, &m)) ...
+ * mymap_del(1, &m);
+ * while ((slot = mymap_next(&pos, &m))) ... slot->key ... slot->value ...
+ * mymap_afini(&m);
+ */
+
+/****************************************
+ * Control bytes.
+ ****************************************/
+
+/* Number of control bytes scanned at once. */
+#define BBHASH_GROUP 16
+
+/* Control bytes of the free slots (a full one has the high bit clear). */
+#define BBHASH_EMPTY   0x80
+#define BBHASH_DELETED 0xFE
+
+/*
+ * Spread the bits of a user hash, so that both the low bits (the control
+ * byte) and the high bits (the position) depend on the whole key.
+ */
+static BBUNUSED size_t bbhash_mix(size_t hash)
+{
+	hash ^= hash >> (sizeof(size_t) * 4);
+	hash *= (size_t)2654435769UL; /* 2^32 divided by the golden ratio. */
+	hash ^= hash >> (sizeof(size_t) * 4);
+	return hash;
+}
+
+/*
+ * Hash a string and a byte array (FNV-1a).
+ */
+static BBUNUSED size_t bbhash_bytes(const void *ptr, size_t len)
+{
+	const unsigned char *byte = ptr;
+	size_t hash = 2166136261UL;
+
+	while (len--) {
+		hash ^= *byte++;
+		hash *= 16777619UL;
+	}
+	return hash;
+}
+
+static BBUNUSED size_t bbhash_str(const char *str)
+{
+	const unsigned char *byte = (const unsigned char *)str;
+	size_t hash = 2166136261UL;
+
+	while (*byte) {
+		hash ^= *byte++;
+		hash *= 16777619UL;
+	}
+	return hash;
+}
+
+/*
+ * Group matching: return the bit mask of the group positions having
+ * the control byte, being empty, or being free (empty or deleted).
+ * A group is compared at once with SSE2 or, on 64-bit words, with SWAR
+ * (where a byte right after a matching one may also be reported).
+ */
+#if defined(BBSSE2)
+
+static BBUNUSED unsigned bbhash_match(const unsigned char *group,
+	unsigned char byte)
+{
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	__m128i pattern = _mm_set1_epi8((char)byte);
+
+	return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, pattern));
+}
+
+static BBUNUSED unsigned bbhash_match_empty(const unsigned char *group)
+{
+	return bbhash_match(group, BBHASH_EMPTY);
+}
+
+static BBUNUSED unsigned bbhash_match_free(const unsigned char *group)
+{
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+
+	return (unsigned)_mm_movemask_epi8(ctrl);
+}
+
+#elif ULONG_MAX > 0xFFFFFFFFUL
+
+#define BBHASH_LSB 0x0101010101010101UL
+#define BBHASH_MSB 0x8080808080808080UL
+
+/* Load 8 control bytes, the first one being the lowest. */
+static BBUNUSED unsigned long bbhash_load(const unsigned char *group)
+{
+	return (unsigned long)group[0] | (unsigned long)group[1] << 8 |
+		(unsigned long)group[2] << 16 | (unsigned long)group[3] << 24 |
+		(unsigned long)group[4] << 32 | (unsigned long)group[5] << 40 |
+		(unsigned long)group[6] << 48 | (unsigned long)group[7] << 56;
+}
+
+/* Gather the high bits of the bytes into 8 low bits. */
+static BBUNUSED unsigned bbhash_gather(unsigned long word)
+{
+	return (unsigned)(((word >> 7) * 0x0102040810204080UL) >> 56);
+}
+
+static BBUNUSED unsigned bbhash_match(const unsigned char *group,
+	unsigned char byte)
+{
+	unsigned long lo = bbhash_load(group) ^ (BBHASH_LSB * byte);
+	unsigned long hi = bbhash_load(group + 8) ^ (BBHASH_LSB * byte);
+
+	lo = (lo - BBHASH_LSB) & ~lo & BBHASH_MSB;
+	hi = (hi - BBHASH_LSB) & ~hi & BBHASH_MSB;
+	return bbhash_gather(lo) | bbhash_gather(hi) << 8;
+}
+
+static BBUNUSED unsigned bbhash_match_empty(const unsigned char *group)
+{
+	unsigned long lo = bbhash_load(group);
+	unsigned long hi = bbhash_load(group + 8);
+
+	/* Only the empty byte has the high bit set and the second bit clear. */
+	lo = lo & ~(lo << 6) & BBHASH_MSB;
+	hi = hi & ~(hi << 6) & BBHASH_MSB;
+	return bbhash_gather(lo) | bbhash_gather(hi) << 8;
+}
+
+static BBUNUSED unsigned bbhash_match_free(const unsigned char *group)
+{
+	unsigned long lo = bbhash_load(group) & BBHASH_MSB;
+	unsigned long hi = bbhash_load(group + 8) & BBHASH_MSB;
+
+	return bbhash_gather(lo) | bbhash_gather(hi) << 8;
+}
+
+#else
+
+static BBUNUSED unsigned bbhash_match(const unsigned char *group,
+	unsigned char byte)
+{
+	unsigned mask = 0;
+	int i;
+
+	for (i = 0; i < BBHASH_GROUP; i++)
+		if (group[i] == byte)
+			mask |= 1U << i;
+	return mask;
+}
+
+static BBUNUSED unsigned bbhash_match_empty(const unsigned char *group)
+{
+	return bbhash_match(group, BBHASH_EMPTY);
+}
+
+static BBUNUSED unsigned bbhash_match_free(const unsigned char *group)
+{
+	unsigned mask = 0;
+	int i;
+
+	for (i = 0; i < BBHASH_GROUP; i++)
+		if (group[i] & 0x80)
+			mask |= 1U << i;
+	return mask;
+}
+
+#endif
+
+/*
+ * Return the lowest position in a non-zero bit mask.
+ */
+static BBUNUSED unsigned bbhash_first(unsigned mask)
+{
+#if defined(__GNUC__)
+	return (unsigned)__builtin_ctz(mask);
+#else
+	unsigned pos = 0;
+
+	while (!(mask & 1)) {
+		mask >>= 1;
+		pos++;
+	}
+	return pos;
+#endif
+}
+
+/*
+ * Set a control byte. The first bytes are mirrored after the end,
+ * so that a group can be read from any position without wrapping.
+ */
+static BBUNUSED void bbhash_setctrl(size_t pos, unsigned char byte,
+	unsigned char *ctrl, size_t cap)
+{
+	ctrl[pos] = byte;
+	if (pos < BBHASH_GROUP - 1)
+		ctrl[cap + pos] = byte;
+}
+
+/*
+ * Find a free slot for a hash. The table must have one.
+ * The groups are probed in the triangular sequence.
+ */
+static BBUNUSED size_t bbhash_findfree(size_t hash,
+	const unsigned char *ctrl, size_t cap)
+{
+	size_t mask = cap - 1;
+	size_t pos = (hash >> 7) & mask;
+	size_t step = 0;
+	unsigned match;
+
+	while (!(match = bbhash_match_free(&ctrl[pos]))) {
+		step += BBHASH_GROUP;
+		pos = (pos + step) & mask;
+	}
+	return (pos + bbhash_first(match)) & mask;
+}
+
+/*
+ * Number of slots to hold a number of entries without growth.
+ * On overflow, return the maximum value no allocator can satisfy.
+ */
+static BBUNUSED size_t bbhash_capacity(size_t num)
+{
+	size_t cap = BBHASH_GROUP;
+
+	while (cap - cap / 8 < num) {
+		cap <<= 1;
+		if (cap == 0) /* Check for integer overflow. */
+			return (size_t)-1;
+	}
+	return cap;
+}
+
+/*
+ * Number of slot-sized units holding the slots and their control bytes.
+ * On overflow, return the maximum value no allocator can satisfy.
+ */
+static BBUNUSED size_t bbhash_memlen(size_t cap, size_t size)
+{
+	if (cap > (size_t)-1 / 2) /* Check for integer overflow. */
+		return (size_t)-1;
+	return cap + (cap + BBHASH_GROUP - 1 + size - 1) / size;
+}
+
+/****************************************
+ * Hash Table interface (common to maps and sets).
+ ****************************************/
+
+/* Hash Table structure members. */
+#define HASHTABLE_MEMBERS(HT) \
+	size_t len, cap; /* Number of entries and of slots. */ \
+	size_t left; /* Number of entries to insert before growth. */ \
+	unsigned char *ctrl; /* Control bytes (after the slots). */ \
+	struct HT##_slot *slot /* Beginning of memory. */
+
+/*
+ * Hash Table core procedures.
+ * The memory for `cap` slots is `bbhash_memlen(cap, sizeof(slot))` slots.
+ */
+#define HASHTABLE_CORE_DECLARATIONS(HT, PREFIX) \
+\
+PREFIX void HT##_init(struct HT##_slot *array, size_t cap, struct HT *ht); \
+PREFIX struct HT##_slot *HT##_fini(struct HT *ht); \
+PREFIX void HT##_clear(struct HT *ht); \
+PREFIX int HT##_full(struct HT *ht); \
+PREFIX struct HT##_slot *HT##_next(size_t *pos, struct HT *ht); \
+\
+PREFIX struct HT##_slot *HT##_reserve(struct HT##_slot *array, size_t cap, \
+	struct HT *ht); \
+bbstatic_semicolon
+
+/*
+ * Hash Table automatic memory management appendix.
+ * The number passed to `ainit` and `areserve` is the number of entries.
+ */
+#define HASHTABLE_AUTO_DECLARATIONS(HT, PREFIX) \
+\
+PREFIX void HT##_ainit(size_t num, struct HT *ht); \
+PREFIX void HT##_afini(struct HT *ht); \
+PREFIX void HT##_aclear(struct HT *ht); \
+\
+PREFIX void HT##_areserve(size_t num, struct HT *ht); \
+bbstatic_semicolon
+
+/****************************************
+ * Hash Table implementation.
+ ****************************************/
+
+/* Hash Table core procedures. */
+#define HASHTABLE_CORE_IMPLEMENTATION(HT, KEY, HASH, EQ) \
+\
+static BBUNUSED size_t HT##_hash_(KEY key) \
+{	return bbhash_mix(HASH(key)); \
+} \
+static BBUNUSED size_t HT##_find_(KEY key, size_t hash, struct HT *ht) \
+{	size_t mask = ht->cap - 1; \
+	size_t pos = (hash >> 7) & mask; \
+	size_t step = 0; \
+	unsigned char byte = hash & 0x7F; \
+	if (ht->len == 0) \
+		return (size_t)-1; \
+	for (;;) { \
+		unsigned char *group = &ht->ctrl[pos]; \
+		unsigned match = bbhash_match(group, byte); \
+		while (match) { \
+			size_t num = (pos + bbhash_first(match)) & mask; \
+			if (EQ(ht->slot[num].key, key)) \
+				return num; \
+			match &= match - 1; \
+		} \
+		if (bbhash_match_empty(group)) \
+			return (size_t)-1; \
+		step += BBHASH_GROUP; \
+		pos = (pos + step) & mask; \
+	} \
+} \
+static BBUNUSED size_t HT##_insert_(KEY key, size_t hash, struct HT *ht) \
+{	size_t num = bbhash_findfree(hash, ht->ctrl, ht->cap); \
+	if (ht->ctrl[num] == BBHASH_EMPTY) \
+		ht->left--; \
+	bbhash_setctrl(num, hash & 0x7F, ht->ctrl, ht->cap); \
+	ht->slot[num].key = key; \
+	ht->len++; \
+	return num; \
+} \
+static BBUNUSED int HT##_erase_(KEY key, struct HT *ht) \
+{	size_t num = HT##_find_(key, HT##_hash_(key), ht); \
+	if (num == (size_t)-1) \
+		return 0; \
+	bbhash_setctrl(num, BBHASH_DELETED, ht->ctrl, ht->cap); \
+	ht->len--; \
+	return 1; \
+} \
+void HT##_init(struct HT##_slot *array, size_t cap, struct HT *ht) \
+{	ht->slot = array; \
+	ht->ctrl = cap ? (unsigned char *)(array + cap) : NULL; \
+	ht->cap = cap; \
+	HT##_clear(ht); \
+} \
+struct HT##_slot *HT##_fini(struct HT *ht) \
+{	return ht->slot; \
+} \
+void HT##_clear(struct HT *ht) \
+{	if (ht->cap) \
+		memset(ht->ctrl, BBHASH_EMPTY, ht->cap + BBHASH_GROUP - 1); \
+	ht->len = 0; \
+	ht->left = ht->cap - ht->cap / 8; \
+} \
+int HT##_full(struct HT *ht) \
+{	return ht->left == 0; \
+} \
+struct HT##_slot *HT##_next(size_t *pos, struct HT *ht) \
+{	size_t num; \
+	for (num = *pos; num < ht->cap; num++) { \
+		if (!(ht->ctrl[num] & 0x80)) { \
+			*pos = num + 1; \
+			return &ht->slot[num]; \
+		} \
+	} \
+	*pos = ht->cap; \
+	return NULL; \
+} \
+struct HT##_slot *HT##_reserve(struct HT##_slot *array, size_t cap, \
+	struct HT *ht) \
+{	struct HT old = *ht; \
+	size_t num; \
+	HT##_init(array, cap, ht); \
+	for (num = 0; num < old.cap; num++) { \
+		if (!(old.ctrl[num] & 0x80)) { \
+			size_t hash = HT##_hash_(old.slot[num].key); \
+			size_t pos = bbhash_findfree(hash, ht->ctrl, cap); \
+			bbhash_setctrl(pos, hash & 0x7F, ht->ctrl, cap); \
+			ht->slot[pos] = old.slot[num]; \
+		} \
+	} \
+	ht->len = old.len; \
+	ht->left -= old.len; \
+	return old.slot; \
+} \
+bbstatic_semicolon
+
+/*
+ * Hash Table automatic memory management appendix.
+ * A full table is rehashed for the doubled number of entries,
+ * which also drops the deleted slots.
+ */
+#define HASHTABLE_AUTO_IMPLEMENTATION(HT, ALLOC, FREE) \
+\
+void HT##_ainit(size_t num, struct HT *ht) \
+{	size_t cap = num ? bbhash_capacity(num) : 0; \
+	struct HT##_slot *ptr = NULL; \
+	if (cap) \
+		ptr = ALLOC(bbhash_memlen(cap, sizeof(*ptr)), sizeof(*ptr)); \
+	HT##_init(ptr, cap, ht); \
+} \
+void HT##_afini(struct HT *ht) \
+{	FREE(HT##_fini(ht)); \
+} \
+void HT##_aclear(struct HT *ht) \
+{	FREE(ht->slot); \
+	HT##_init(NULL, 0, ht); \
+} \
+void HT##_areserve(size_t num, struct HT *ht) \
+{	size_t cap = bbhash_capacity(num > ht->len ? num : ht->len); \
+	struct HT##_slot *ptr; \
+	ptr = ALLOC(bbhash_memlen(cap, sizeof(*ptr)), sizeof(*ptr)); \
+	FREE(HT##_reserve(ptr, cap, ht)); \
+} \
+static BBUNUSED void HT##_agrow_(struct HT *ht) \
+{	HT##_areserve(ht->len ? ht->len * 2 : 1, ht); \
+} \
+bbstatic_semicolon
+
+/****************************************
+ * Hash Map interface.
+ ****************************************/
+
+/* Hash Map structure. */
+#define HASHMAP_STRUCT(HM, KEY, VALUE) \
+\
+struct HM##_slot { \
+	KEY key; \
+	VALUE value; \
+}; \
+struct HM { \
+	HASHTABLE_MEMBERS(HM); \
+}
+
+/*
+ * Hash Map core procedures.
+ * The `put` procedure returns the value of the key, inserting the key
+ * if it is missing (then the map must not be full and the value is not
+ * initialized). The `del` procedure returns non-zero if the key was found.
+ */
+#define HASHMAP_CORE_DECLARATIONS(HM, KEY, VALUE, PREFIX) \
+	HASHTABLE_CORE_DECLARATIONS(HM, PREFIX); \
+\
+PREFIX VALUE *HM##_get(KEY key, struct HM *hm); \
+PREFIX VALUE *HM##_put(KEY key, struct HM *hm); \
+PREFIX void HM##_set(KEY key, VALUE value, struct HM *hm); \
+PREFIX int HM##_del(KEY key, struct HM *hm); \
+bbstatic_semicolon
+
+/* Hash Map automatic memory management appendix. */
+#define HASHMAP_AUTO_DECLARATIONS(HM, KEY, VALUE, PREFIX) \
+	HASHTABLE_AUTO_DECLARATIONS(HM, PREFIX); \
+\
+PREFIX VALUE *HM##_aput(KEY key, struct HM *hm); \
+PREFIX void HM##_aset(KEY key, VALUE value, struct HM *hm); \
+bbstatic_semicolon
+
+/* Hash Map automatic memory management procedures. */
+#define HASHMAP_DECLARATIONS(HM, KEY, VALUE, PREFIX) \
+	HASHMAP_CORE_DECLARATIONS(HM, KEY, VALUE, PREFIX); \
+	HASHMAP_AUTO_DECLARATIONS(HM, KEY, VALUE, PREFIX)
+
+/* Hash Map core interface. */
+#define HASHMAP_CORE_INTERFACE(HM, KEY, VALUE, PREFIX) \
+	HASHMAP_STRUCT(HM, KEY, VALUE); \
+	HASHMAP_CORE_DECLARATIONS(HM, KEY, VALUE, PREFIX)
+
+/* Hash Map automatic memory management interface. */
+#define HASHMAP_INTERFACE(HM, KEY, VALUE, PREFIX) \
+	HASHMAP_STRUCT(HM, KEY, VALUE); \
+	HASHMAP_DECLARATIONS(HM, KEY, VALUE, PREFIX)
+
+/****************************************
+ * Hash Map implementation.
+ ****************************************/
+
+/* Hash Map core procedures. */
+#define HASHMAP_CORE_IMPLEMENTATION(HM, KEY, VALUE, HASH, EQ) \
+	HASHTABLE_CORE_IMPLEMENTATION(HM, KEY, HASH, EQ); \
+\
+VALUE *HM##_get(KEY key, struct HM *hm) \
+{	size_t num = HM##_find_(key, HM##_hash_(key), hm); \
+	return num == (size_t)-1 ? NULL : &hm->slot[num].value; \
+} \
+VALUE *HM##_put(KEY key, struct HM *hm) \
+{	size_t hash = HM##_hash_(key); \
+	size_t num = HM##_find_(key, hash, hm); \
+	if (num == (size_t)-1) \
+		num = HM##_insert_(key, hash, hm); \
+	return &hm->slot[num].value; \
+} \
+void HM##_set(KEY key, VALUE value, struct HM *hm) \
+{	*HM##_put(key, hm) = value; \
+} \
+int HM##_del(KEY key, struct HM *hm) \
+{	return HM##_erase_(key, hm); \
+} \
+bbstatic_semicolon
+
+/* Hash Map automatic memory management appendix. */
+#define HASHMAP_AUTO_IMPLEMENTATION(HM, KEY, VALUE, ALLOC, FREE) \
+	HASHTABLE_AUTO_IMPLEMENTATION(HM, ALLOC, FREE); \
+\
+VALUE *HM##_aput(KEY key, struct HM *hm) \
+{	size_t hash = HM##_hash_(key); \
+	size_t num = HM##_find_(key, hash, hm); \
+	if (num == (size_t)-1) { \
+		if (HM##_full(hm)) \
+			HM##_agrow_(hm); \
+		num = HM##_insert_(key, hash, hm); \
+	} \
+	return &hm->slot[num].value; \
+} \
+void HM##_aset(KEY key, VALUE value, struct HM *hm) \
+{	*HM##_aput(key, hm) = value; \
+} \
+bbstatic_semicolon
+
+/* Hash Map automatic memory management procedures. */
+#define HASHMAP_IMPLEMENTATION(HM, KEY, VALUE, HASH, EQ, ALLOC, FREE) \
+	HASHMAP_CORE_IMPLEMENTATION(HM, KEY, VALUE, HASH, EQ); \
+	HASHMAP_AUTO_IMPLEMENTATION(HM, KEY, VALUE, ALLOC, FREE)
+
+/* Hash Map core full. */
+#define HASHMAP_CORE(HM, KEY, VALUE, HASH, EQ) \
+	HASHMAP_CORE_INTERFACE(HM, KEY, VALUE, static BBUNUSED); \
+	HASHMAP_CORE_IMPLEMENTATION(HM, KEY, VALUE, HASH, EQ)
+
+/* Hash Map automatic memory management full. */
+#define HASHMAP(HM, KEY, VALUE, HASH, EQ, ALLOC, FREE) \
+	HASHMAP_INTERFACE(HM, KEY, VALUE, static BBUNUSED); \
+	HASHMAP_IMPLEMENTATION(HM, KEY, VALUE, HASH, EQ, ALLOC, FREE)
+
+/****************************************
+ * Hash Set interface.
+ ****************************************/
+
+/* Hash Set structure. */
+#define HASHSET_STRUCT(HS, KEY) \
+\
+struct HS##_slot { \
+	KEY key; \
+}; \
+struct HS { \
+	HASHTABLE_MEMBERS(HS); \
+}
+
+/*
+ * Hash Set core procedures.
+ * The `add` procedure returns non-zero if the key was missing
+ * (then the set must not be full). The `del` procedure returns
+ * non-zero if the key was found.
+ */
+#define HASHSET_CORE_DECLARATIONS(HS, KEY, PREFIX) \
+	HASHTABLE_CORE_DECLARATIONS(HS, PREFIX); \
+\
+PREFIX int HS##_has(KEY key, struct HS *hs); \
+PREFIX int HS##_add(KEY key, struct HS *hs); \
+PREFIX int HS##_del(KEY key, struct HS *hs); \
+bbstatic_semicolon
+
+/* Hash Set automatic memory management appendix. */
+#define HASHSET_AUTO_DECLARATIONS(HS, KEY, PREFIX) \
+	HASHTABLE_AUTO_DECLARATIONS(HS, PREFIX); \
+\
+PREFIX int HS##_aadd(KEY key, struct HS *hs); \
+bbstatic_semicolon
+
+/* Hash Set automatic memory management procedures. */
+#define HASHSET_DECLARATIONS(HS, KEY, PREFIX) \
+	HASHSET_CORE_DECLARATIONS(HS, KEY, PREFIX); \
+	HASHSET_AUTO_DECLARATIONS(HS, KEY, PREFIX)
+
+/* Hash Set core interface. */
+#define HASHSET_CORE_INTERFACE(HS, KEY, PREFIX) \
+	HASHSET_STRUCT(HS, KEY); \
+	HASHSET_CORE_DECLARATIONS(HS, KEY, PREFIX)
+
+/* Hash Set automatic memory management interface. */
+#define HASHSET_INTERFACE(HS, KEY, PREFIX) \
+	HASHSET_STRUCT(HS, KEY); \
+	HASHSET_DECLARATIONS(HS, KEY, PREFIX)
+
+/****************************************
+ * Hash Set implementation.
+ ****************************************/
+
+/* Hash Set core procedures. */
+#define HASHSET_CORE_IMPLEMENTATION(HS, KEY, HASH, EQ) \
+	HASHTABLE_CORE_IMPLEMENTATION(HS, KEY, HASH, EQ); \
+\
+int HS##_has(KEY key, struct HS *hs) \
+{	return HS##_find_(key, HS##_hash_(key), hs) != (size_t)-1; \
+} \
+int HS##_add(KEY key, struct HS *hs) \
+{	size_t hash = HS##_hash_(key); \
+	if (HS##_find_(key, hash, hs) != (size_t)-1) \
+		return 0; \
+	HS##_insert_(key, hash, hs); \
+	return 1; \
+} \
+int HS##_del(KEY key, struct HS *hs) \
+{	return HS##_erase_(key, hs); \
+} \
+bbstatic_semicolon
+
+/* Hash Set automatic memory management appendix. */
+#define HASHSET_AUTO_IMPLEMENTATION(HS, KEY, ALLOC, FREE) \
+	HASHTABLE_AUTO_IMPLEMENTATION(HS, ALLOC, FREE); \
+\
+int HS##_aadd(KEY key, struct HS *hs) \
+{	size_t hash = HS##_hash_(key); \
+	if (HS##_find_(key, hash, hs) != (size_t)-1) \
+		return 0; \
+	if (HS##_full(hs)) \
+		HS##_agrow_(hs); \
+	HS##_insert_(key, hash, hs); \
+	return 1; \
+} \
+bbstatic_semicolon
+
+/* Hash Set automatic memory management procedures. */
+#define HASHSET_IMPLEMENTATION(HS, KEY, HASH, EQ, ALLOC, FREE) \
+	HASHSET_CORE_IMPLEMENTATION(HS, KEY, HASH, EQ); \
+	HASHSET_AUTO_IMPLEMENTATION(HS, KEY, ALLOC, FREE)
+
+/* Hash Set core full. */
+#define HASHSET_CORE(HS, KEY, HASH, EQ) \
+	HASHSET_CORE_INTERFACE(HS, KEY, static BBUNUSED); \
+	HASHSET_CORE_IMPLEMENTATION(HS, KEY, HASH, EQ)
+
+/* Hash Set automatic memory management full. */
+#define HASHSET(HS, KEY, HASH, EQ, ALLOC, FREE) \
+	HASHSET_INTERFACE(HS, KEY, static BBUNUSED); \
+	HASHSET_IMPLEMENTATION(HS, KEY, HASH, EQ, ALLOC, FREE)
+
+#endif
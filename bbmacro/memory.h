@@ -5,8 +5,23 @@
 #define NOINCLUDE
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
 #include <bbmacro/vector.h>
+#include <bbmacro/hashmap.h>
+#include <bbmacro/pqueue.h>
+#include <bbmacro/soa.h>
+#ifdef BBMEMORY_MMAP
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#ifdef BBMEMORY_STATS
+#include <stdio.h>
+#include <bbmacro/ansicolor.h>
+#endif
 #undef NOINCLUDE
 #endif
 
@@ -26,6 +41,29 @@ static BBUNUSED void *bbmemory_alloc(size_t len, size_t size)
 	return res;
 }
 
+/*
+ * Reallocate memory. Abort if impossible.
+ * The zero size frees the memory and returns NULL.
+ * Large blocks are usually moved by the system without copying
+ * (e.g. glibc uses `mremap()` for the memory-mapped chunks).
+ */
+static BBUNUSED void *bbmemory_realloc(void *ptr, size_t len, size_t size)
+{
+	void *res;
+	size_t total = len * size;
+
+	if (total / size != len) /* Check for integer overflow. */
+		abort();
+	if (total == 0) {
+		free(ptr);
+		return NULL;
+	}
+	res = realloc(ptr, total);
+	if (!res) /* Check if memory was allocated. */
+		abort();
+	return res;
+}
+
 /*
  * Increase capacity of a container logarithmically.
  * The base is chosen smaller than the golden ratio.
@@ -43,14 +81,803 @@ static BBUNUSED size_t bbmemory_increase(size_t cap)
 	}
 }
 
+/*
+ * Allocate memory. Return NULL if impossible.
+ */
+static BBUNUSED void *bbmemory_tryalloc(size_t len, size_t size)
+{
+	size_t total = len * size;
+
+	if (total / size != len) /* Check for integer overflow. */
+		return NULL;
+	return malloc(total);
+}
+
+/*
+ * Reallocate memory. Return NULL if impossible (the memory is kept then).
+ * The zero size frees the memory and returns NULL.
+ */
+static BBUNUSED void *bbmemory_tryrealloc(void *ptr, size_t len, size_t size)
+{
+	size_t total = len * size;
+
+	if (total / size != len) /* Check for integer overflow. */
+		return NULL;
+	if (total == 0) {
+		free(ptr);
+		return NULL;
+	}
+	return realloc(ptr, total);
+}
+
+/*
+ * Increase capacity like `bbmemory_increase()`, but never abort.
+ * On overflow, return the maximum value no allocator can satisfy.
+ */
+static BBUNUSED size_t bbmemory_tryincrease(size_t cap)
+{
+	if (cap <= 3) {
+		return cap + 1;
+	} else {
+		size_t newcap = cap + (cap >> 1); /* Multiply by 3/2. */
+		if (newcap <= cap) /* Check for integer overflow. */
+			return (size_t)-1;
+		return newcap;
+	}
+}
+
+/*
+ * Decrease capacity of a container when it is mostly empty.
+ * The shrinking happens only below a quarter of the capacity and leaves
+ * the half of it free, so pushing and popping around the same length
+ * never reallocates back and forth. Small capacities are kept.
+ */
+static BBUNUSED size_t bbmemory_decrease(size_t len, size_t cap)
+{
+	size_t newcap = len + len; /* Multiply by 2. */
+
+	if (cap <= 16 || len >= cap / 4)
+		return cap;
+	return newcap < 16 ? 16 : newcap;
+}
+
+/****************************************
+ * Aligned allocator.
+ ****************************************/
+
+/*
+ * The blocks are aligned to a given power of two (e.g. a cache line or
+ * a SIMD register width), which `malloc()` does not guarantee beyond the
+ * alignment of the basic types. C11 `aligned_alloc()` or POSIX
+ * `posix_memalign()` is used when available; otherwise a larger block is
+ * allocated and the pointer to it is kept just before the aligned block.
+ * The blocks must be freed with `bbmemory_alignfree()`.
+ */
+#if __STDC_VERSION__ >= 201112L
+#  define BBMEMORY_ALIGNED_ALLOC
+#elif (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L) || \
+	(defined(_XOPEN_SOURCE) && _XOPEN_SOURCE >= 600)
+#  define BBMEMORY_POSIX_MEMALIGN
+#endif
+
+/*
+ * Allocate aligned memory. Abort if impossible.
+ * An alignment smaller than a pointer is raised to the size of a pointer.
+ */
+static BBUNUSED void *bbmemory_alignalloc(size_t len, size_t size,
+	size_t align)
+{
+	void *res;
+	size_t total = len * size;
+
+	if (total / size != len) /* Check for integer overflow. */
+		abort();
+	if (align & (align - 1)) /* Not a power of two. */
+		abort();
+	if (align < sizeof(void *))
+		align = sizeof(void *);
+	if (total == 0) /* Keep the blocks distinct. */
+		total = align;
+	if (total + (align - 1) < total) /* Check for integer overflow. */
+		abort();
+#if defined(BBMEMORY_ALIGNED_ALLOC)
+	/* The size must be a multiple of the alignment. */
+	res = aligned_alloc(align, (total + (align - 1)) & ~(align - 1));
+#elif defined(BBMEMORY_POSIX_MEMALIGN)
+	if (posix_memalign(&res, align, total))
+		res = NULL;
+#else
+	if (total + (align - 1) + sizeof(void *) < total) /* Overflow. */
+		abort();
+	res = malloc(total + (align - 1) + sizeof(void *));
+	if (res) {
+		void *base = res;
+		res = (char *)res + sizeof(void *);
+		res = (char *)res + ((align - (size_t)res % align) & (align - 1));
+		((void **)res)[-1] = base;
+	}
+#endif
+	if (!res) /* Check if memory was allocated. */
+		abort();
+	return res;
+}
+
+/*
+ * Free aligned memory.
+ */
+static BBUNUSED void bbmemory_alignfree(void *ptr)
+{
+#if defined(BBMEMORY_ALIGNED_ALLOC) || defined(BBMEMORY_POSIX_MEMALIGN)
+	free(ptr);
+#else
+	if (ptr)
+		free(((void **)ptr)[-1]);
+#endif
+}
+
+/*
+ * Define an allocator with a fixed alignment for containers.
+ * The procedures `NAME_alloc` and `NAME_free` are defined.
+ * Usage:
+ * BBMEMORY_ALIGNED(simd, 64);
+ * BVECTOR(myvector, float, simd_alloc, simd_free, bbmemory_increase);
+ */
+#define BBMEMORY_ALIGNED(NAME, ALIGN) \
+\
+static BBUNUSED void *NAME##_alloc(size_t len, size_t size) \
+{	return bbmemory_alignalloc(len, size, (ALIGN)); \
+} \
+static BBUNUSED void NAME##_free(void *ptr) \
+{	bbmemory_alignfree(ptr); \
+} \
+bbstatic_semicolon
+
+#ifdef BBMEMORY_MMAP
+
+/****************************************
+ * Memory-mapped allocator (POSIX, opt-in).
+ ****************************************/
+
+/*
+ * The blocks are anonymous memory mappings, meant for very large vectors.
+ * 1. The pages are committed on the first touch, and the mappings are
+ *    created with MAP_NORESERVE (where available), so a large capacity
+ *    costs only the address space until it is used.
+ * 2. A block grows with `mremap()` (on Linux), which moves the page tables
+ *    instead of copying the data; elsewhere it is copied to a new mapping.
+ * 3. Big blocks are advised to use transparent huge pages (MADV_HUGEPAGE).
+ *    With BBMEMORY_MMAP_HUGETLB defined, the reserved huge pages
+ *    (MAP_HUGETLB) are tried first.
+ * 4. Every block starts with a header keeping the size of the mapping.
+ * Define BBMEMORY_MMAP (and `_GNU_SOURCE` for `mremap()` on Linux)
+ * before including this file.
+ * Usage:
+ * BVECTOR_MMAP_DEFAULT(myvector, double);
+ */
+
+/* Size of the block header (keeps the data aligned to a cache line). */
+#define BBMEMORY_MMAP_HEADER 64
+
+/* Size of a huge page (for MAP_HUGETLB and MADV_HUGEPAGE). */
+#ifndef BBMEMORY_HUGEPAGE
+#  define BBMEMORY_HUGEPAGE ((size_t)2 << 20)
+#endif
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#  define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#ifndef MAP_NORESERVE
+#  define MAP_NORESERVE 0
+#endif
+
+/* Block header. */
+union bbmemory_mmap {
+	struct {
+		size_t size; /* Size of the mapping. */
+		int huge; /* Mapped with MAP_HUGETLB. */
+	} h;
+	char pad[BBMEMORY_MMAP_HEADER];
+};
+
+/*
+ * Round the size of a mapping up to a multiple of `unit` (a power of two).
+ * Return 0 on overflow.
+ */
+static BBUNUSED size_t bbmemory_mmap_round(size_t total, size_t unit)
+{
+	if (total + BBMEMORY_MMAP_HEADER + (unit - 1) < total)
+		return 0;
+	return (total + BBMEMORY_MMAP_HEADER + (unit - 1)) & ~(unit - 1);
+}
+
+/*
+ * Create a mapping of at least `total` bytes of data. Return NULL if
+ * impossible.
+ */
+static BBUNUSED union bbmemory_mmap *bbmemory_mmap_map(size_t total)
+{
+	union bbmemory_mmap *map;
+	size_t size;
+
+#if defined(BBMEMORY_MMAP_HUGETLB) && defined(MAP_HUGETLB)
+	size = bbmemory_mmap_round(total, BBMEMORY_HUGEPAGE);
+	if (size == 0)
+		return NULL;
+	/* Without MAP_NORESERVE, the mapping fails if there are no huge pages
+	 * reserved (instead of a signal on the first touch). */
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (map != MAP_FAILED) {
+		map->h.size = size;
+		map->h.huge = 1;
+		return map;
+	}
+#endif
+	size = bbmemory_mmap_round(total, (size_t)sysconf(_SC_PAGESIZE));
+	if (size == 0)
+		return NULL;
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (map == MAP_FAILED)
+		return NULL;
+#ifdef MADV_HUGEPAGE
+	if (size >= BBMEMORY_HUGEPAGE)
+		madvise(map, size, MADV_HUGEPAGE);
+#endif
+	map->h.size = size;
+	map->h.huge = 0;
+	return map;
+}
+
+/*
+ * Reallocate memory as a mapping. Abort if impossible.
+ * The zero size frees the memory and returns NULL.
+ */
+static BBUNUSED void *bbmemory_mmap_realloc(void *ptr, size_t len, size_t size)
+{
+	union bbmemory_mmap *map, *old;
+	size_t total = len * size;
+
+	if (total / size != len) /* Check for integer overflow. */
+		abort();
+	if (!ptr) {
+		if (total == 0)
+			return NULL;
+		map = bbmemory_mmap_map(total);
+		if (!map)
+			abort();
+		return map + 1;
+	}
+	old = (union bbmemory_mmap *)ptr - 1;
+	if (total == 0) {
+		munmap(old, old->h.size);
+		return NULL;
+	}
+#ifdef MREMAP_MAYMOVE
+	if (!old->h.huge) {
+		size_t newsize = bbmemory_mmap_round(total,
+			(size_t)sysconf(_SC_PAGESIZE));
+		if (newsize == 0)
+			abort();
+		if (newsize == old->h.size)
+			return ptr;
+		map = mremap(old, old->h.size, newsize, MREMAP_MAYMOVE);
+		if (map == MAP_FAILED)
+			abort();
+#ifdef MADV_HUGEPAGE
+		if (newsize >= BBMEMORY_HUGEPAGE)
+			madvise(map, newsize, MADV_HUGEPAGE);
+#endif
+		map->h.size = newsize;
+		return map + 1;
+	}
+#endif
+	if (total + BBMEMORY_MMAP_HEADER <= old->h.size &&
+		total + BBMEMORY_MMAP_HEADER > old->h.size / 2)
+		return ptr; /* Neither grows nor shrinks enough to move. */
+	map = bbmemory_mmap_map(total);
+	if (!map)
+		abort();
+	memcpy(map + 1, ptr, old->h.size - BBMEMORY_MMAP_HEADER < total ?
+		old->h.size - BBMEMORY_MMAP_HEADER : total);
+	munmap(old, old->h.size);
+	return map + 1;
+}
+
+/*
+ * Free memory of a mapping.
+ */
+static BBUNUSED void bbmemory_mmap_free(void *ptr)
+{
+	if (ptr) {
+		union bbmemory_mmap *map = (union bbmemory_mmap *)ptr - 1;
+		munmap(map, map->h.size);
+	}
+}
+
+#endif
+
+/****************************************
+ * Arena allocator.
+ ****************************************/
+
+/*
+ * The arena hands out memory from big chunks by bumping a pointer.
+ * The blocks are not freed one by one: the memory is given back
+ * all at once, either up to a mark or by resetting the whole arena.
+ * Usage:
+ * struct bbmemory_arena arena;
+ * struct bbmemory_mark mark;
+ * bbmemory_arena_init(65536, &arena);
+ * bbmemory_arena_mark(&mark, &arena);
+ * ... allocate ...
+ * bbmemory_arena_release(&mark, &arena);
+ * ... allocate ...
+ * bbmemory_arena_reset(&arena);
+ * bbmemory_arena_fini(&arena);
+ */
+
+/* Type with the strictest alignment. */
+union bbmemory_align {
+	long l;
+	double d;
+	long double ld;
+	void *p;
+	void (*f)(void);
+};
+
+/* Header of an arena chunk. The memory follows the header. */
+union bbmemory_chunk {
+	struct {
+		union bbmemory_chunk *prev; /* Previous chunk. */
+		char *end; /* End of memory. */
+	} h;
+	union bbmemory_align align;
+};
+
+/* Arena. */
+struct bbmemory_arena {
+	union bbmemory_chunk *top; /* Current chunk. */
+	char *ptr, *end; /* Free memory of the current chunk. */
+	char *last; /* The last allocated block. */
+	size_t size; /* Minimal size of a chunk. */
+};
+
+/* Position in an arena to release the memory to. */
+struct bbmemory_mark {
+	union bbmemory_chunk *top;
+	char *ptr;
+};
+
+/*
+ * Initialize an empty arena. No memory is allocated until it is needed.
+ */
+static BBUNUSED void bbmemory_arena_init(size_t size,
+	struct bbmemory_arena *arena)
+{
+	arena->top = NULL;
+	arena->ptr = NULL;
+	arena->end = NULL;
+	arena->last = NULL;
+	arena->size = size;
+}
+
+/*
+ * Release all the memory of an arena.
+ */
+static BBUNUSED void bbmemory_arena_fini(struct bbmemory_arena *arena)
+{
+	union bbmemory_chunk *chunk = arena->top;
+
+	while (chunk) {
+		union bbmemory_chunk *prev = chunk->h.prev;
+		free(chunk);
+		chunk = prev;
+	}
+}
+
+/*
+ * Allocate memory from an arena. Abort if impossible.
+ */
+static BBUNUSED void *bbmemory_arena_alloc(size_t len, size_t size,
+	struct bbmemory_arena *arena)
+{
+	size_t align = sizeof(union bbmemory_align);
+	size_t total = len * size;
+
+	if (total / size != len) /* Check for integer overflow. */
+		abort();
+	if (total + (align - 1) < total) /* Check for integer overflow. */
+		abort();
+	total = (total + (align - 1)) / align * align;
+	if (total == 0) /* Keep the blocks distinct. */
+		total = align;
+
+	if (total > (size_t)(arena->end - arena->ptr)) {
+		union bbmemory_chunk *chunk;
+		size_t chunksize = arena->size > total ? arena->size : total;
+
+		if (chunksize + sizeof(*chunk) < chunksize) /* Overflow. */
+			abort();
+		chunk = malloc(chunksize + sizeof(*chunk));
+		if (!chunk) /* Check if memory was allocated. */
+			abort();
+		chunk->h.prev = arena->top;
+		chunk->h.end = (char *)(chunk + 1) + chunksize;
+		arena->top = chunk;
+		arena->ptr = (char *)(chunk + 1);
+		arena->end = chunk->h.end;
+	}
+	arena->last = arena->ptr;
+	arena->ptr += total;
+	return arena->last;
+}
+
+/*
+ * Free a block of an arena.
+ * Only the last allocated block is really given back.
+ */
+static BBUNUSED void bbmemory_arena_free(void *ptr,
+	struct bbmemory_arena *arena)
+{
+	if (ptr && ptr == arena->last) {
+		arena->ptr = arena->last;
+		arena->last = NULL;
+	}
+}
+
+/*
+ * Remember the current position of an arena.
+ */
+static BBUNUSED void bbmemory_arena_mark(struct bbmemory_mark *mark,
+	struct bbmemory_arena *arena)
+{
+	mark->top = arena->top;
+	mark->ptr = arena->ptr;
+}
+
+/*
+ * Release all the blocks allocated after the mark.
+ */
+static BBUNUSED void bbmemory_arena_release(struct bbmemory_mark *mark,
+	struct bbmemory_arena *arena)
+{
+	while (arena->top != mark->top) {
+		union bbmemory_chunk *prev = arena->top->h.prev;
+		free(arena->top);
+		arena->top = prev;
+	}
+	arena->ptr = mark->ptr;
+	arena->end = arena->top ? arena->top->h.end : NULL;
+	arena->last = NULL;
+}
+
+/*
+ * Release all the blocks, but keep the current chunk for the future.
+ */
+static BBUNUSED void bbmemory_arena_reset(struct bbmemory_arena *arena)
+{
+	union bbmemory_chunk *chunk = arena->top;
+
+	if (!chunk)
+		return;
+	while (chunk->h.prev) {
+		union bbmemory_chunk *prev = chunk->h.prev->h.prev;
+		free(chunk->h.prev);
+		chunk->h.prev = prev;
+	}
+	arena->ptr = (char *)(chunk + 1);
+	arena->last = NULL;
+}
+
+/*
+ * Define the allocator pair `NAME_alloc` and `NAME_free` bound to an arena.
+ * ARENA is an expression evaluated on every call: a pointer to a global
+ * arena, a function returning the arena of the current request, etc.
+ * Usage:
+ * BBMEMORY_ARENA(request, &request_arena);
+ * BVECTOR_ARENA(myvector, int, request);
+ */
+#define BBMEMORY_ARENA(NAME, ARENA) \
+\
+static BBUNUSED void *NAME##_alloc(size_t len, size_t size) \
+{	return bbmemory_arena_alloc(len, size, (ARENA)); \
+} \
+static BBUNUSED void NAME##_free(void *ptr) \
+{	bbmemory_arena_free(ptr, (ARENA)); \
+} \
+bbstatic_semicolon
+
+/****************************************
+ * Pool allocator.
+ ****************************************/
+
+/*
+ * The pool keeps the freed blocks in per-class free lists and hands them
+ * out again instead of calling `malloc()`. The size classes follow the
+ * same 3/2 progression as `bbmemory_increase()`, so the capacities of
+ * the vectors of the same element type fall into the same few classes.
+ * The blocks bigger than the largest class go directly to the heap.
+ * The pool is private to a translation unit and it is not thread-safe,
+ * unless BBMEMORY_POOL_THREAD is defined: then every thread has its own
+ * pool (see BBTHREADLOCAL). Any block may be freed by any pool.
+ */
+
+/* Number of size classes. */
+#ifndef BBMEMORY_POOL_CLASSES
+#define BBMEMORY_POOL_CLASSES 32
+#endif
+
+/* Maximum number of cached blocks in a class. */
+#ifndef BBMEMORY_POOL_DEPTH
+#define BBMEMORY_POOL_DEPTH 16
+#endif
+
+/* Size of the smallest class. */
+#define BBMEMORY_POOL_MIN 16
+
+/* Header of a pool block. The memory follows the header. */
+union bbmemory_block {
+	union bbmemory_block *next; /* Next cached block. */
+	size_t cls; /* Size class of a used block. */
+	union bbmemory_align align;
+};
+
+/* Free lists of the pool. */
+struct bbmemory_pool {
+	union bbmemory_block *head[BBMEMORY_POOL_CLASSES];
+	size_t count[BBMEMORY_POOL_CLASSES];
+};
+
+#ifdef BBMEMORY_POOL_THREAD
+static BBTHREADLOCAL BBUNUSED struct bbmemory_pool bbmemory_pool_cache;
+#else
+static BBUNUSED struct bbmemory_pool bbmemory_pool_cache;
+#endif
+
+/*
+ * Find the size class of a block and the size of its memory.
+ * BBMEMORY_POOL_CLASSES means the block has no class.
+ */
+static BBUNUSED size_t bbmemory_pool_class(size_t total, size_t *size)
+{
+	size_t cls = 0, cap = BBMEMORY_POOL_MIN;
+
+	while (cap < total && cls < BBMEMORY_POOL_CLASSES) {
+		cap += cap >> 1; /* Multiply by 3/2. */
+		cls++;
+	}
+	*size = cls < BBMEMORY_POOL_CLASSES ? cap : total;
+	return cls;
+}
+
+/*
+ * Allocate memory from the pool. Abort if impossible.
+ */
+static BBUNUSED void *bbmemory_pool_alloc(size_t len, size_t size)
+{
+	struct bbmemory_pool *pool = &bbmemory_pool_cache;
+	union bbmemory_block *block;
+	size_t total = len * size;
+	size_t cls;
+
+	if (total / size != len) /* Check for integer overflow. */
+		abort();
+	cls = bbmemory_pool_class(total, &total);
+	if (cls < BBMEMORY_POOL_CLASSES && pool->head[cls]) {
+		block = pool->head[cls];
+		pool->head[cls] = block->next;
+		pool->count[cls]--;
+	} else {
+		if (total + sizeof(*block) < total) /* Overflow. */
+			abort();
+		block = malloc(total + sizeof(*block));
+		if (!block) /* Check if memory was allocated. */
+			abort();
+	}
+	block->cls = cls;
+	return block + 1;
+}
+
+/*
+ * Give memory back to the pool.
+ */
+static BBUNUSED void bbmemory_pool_free(void *ptr)
+{
+	struct bbmemory_pool *pool = &bbmemory_pool_cache;
+	union bbmemory_block *block;
+	size_t cls;
+
+	if (!ptr)
+		return;
+	block = (union bbmemory_block *)ptr - 1;
+	cls = block->cls;
+	if (cls < BBMEMORY_POOL_CLASSES &&
+		pool->count[cls] < BBMEMORY_POOL_DEPTH) {
+		block->next = pool->head[cls];
+		pool->head[cls] = block;
+		pool->count[cls]++;
+	} else {
+		free(block);
+	}
+}
+
+/*
+ * Give all the cached blocks of the pool back to the heap.
+ */
+static BBUNUSED void bbmemory_pool_trim(void)
+{
+	struct bbmemory_pool *pool = &bbmemory_pool_cache;
+	size_t cls;
+
+	for (cls = 0; cls < BBMEMORY_POOL_CLASSES; cls++) {
+		while (pool->head[cls]) {
+			union bbmemory_block *next = pool->head[cls]->next;
+			free(pool->head[cls]);
+			pool->head[cls] = next;
+		}
+		pool->count[cls] = 0;
+	}
+}
+
+/****************************************
+ * Instrumentation.
+ ****************************************/
+
+/*
+ * When BBMEMORY_STATS is defined, every vector type with the automatic
+ * memory management counts its memory operations in `V_stats()`.
+ * Otherwise, nothing is generated and nothing is counted.
+ * The counters are not atomic: use one thread per vector type.
+ * Usage:
+ * BVECTOR_DEFAULT(myvector, int);
+ * ...
+ * BBMEMORY_STATS_DUMP(myvector, stderr);
+ */
+
+#ifdef BBMEMORY_STATS
+
+/* Memory statistics of a vector type. */
+struct bbmemory_stats {
+	size_t allocs; /* Number of allocations. */
+	size_t frees; /* Number of frees. */
+	size_t growths; /* Number of increases of capacity. */
+	size_t copied; /* Bytes copied by reservations. */
+	size_t peak; /* Peak capacity. */
+};
+
+static BBUNUSED void bbmemory_stats_alloc(size_t cap,
+	struct bbmemory_stats *stats)
+{
+	stats->allocs++;
+	if (cap > stats->peak)
+		stats->peak = cap;
+}
+
+static BBUNUSED void bbmemory_stats_free(struct bbmemory_stats *stats)
+{
+	stats->frees++;
+}
+
+static BBUNUSED void bbmemory_stats_copy(size_t oldcap, size_t newcap,
+	size_t bytes, struct bbmemory_stats *stats)
+{
+	if (newcap > oldcap)
+		stats->growths++;
+	stats->copied += bytes;
+}
+
+/*
+ * Print the statistics. The number of live blocks is red if it is
+ * not zero (a leak, if the program is about to exit).
+ */
+static BBUNUSED void bbmemory_stats_dump(const char *name,
+	struct bbmemory_stats *stats, FILE *file)
+{
+	unsigned long live = (unsigned long)(stats->allocs - stats->frees);
+
+	fprintf(file, ANSICOLOR_1(BOLD, "%s") ":"
+		" allocs %lu, frees %lu, live %s%lu" ANSICOLOR_RESET() ","
+		" growths %lu, copied %lu B, peak %lu\n",
+		name, (unsigned long)stats->allocs,
+		(unsigned long)stats->frees,
+		live ? ANSICOLOR_SET_1(R) : ANSICOLOR_SET_1(G), live,
+		(unsigned long)stats->growths, (unsigned long)stats->copied,
+		(unsigned long)stats->peak);
+}
+
+#  define BBMEMORY_STATS_DUMP(V, file) \
+	bbmemory_stats_dump(#V, V##_stats(), (file))
+#else
+#  define BBMEMORY_STATS_DUMP(V, file) ((void)0)
+#endif
+
+/****************************************
+ * Vectors.
+ ****************************************/
+
 /* Backward Vector. */
 
 #define BVECTOR_DEFAULT_IMPLEMENTATION(BV, ELEMENT) \
+	BVECTOR_REALLOC_IMPLEMENTATION(BV, ELEMENT, \
+		bbmemory_realloc, free, bbmemory_increase)
+
+#define BVECTOR_DEFAULT(BV, ELEMENT) \
+	BVECTOR_REALLOC(BV, ELEMENT, bbmemory_realloc, free, bbmemory_increase)
+
+#define BVECTOR_ARENA_IMPLEMENTATION(BV, ELEMENT, NAME) \
+	BVECTOR_IMPLEMENTATION(BV, ELEMENT, \
+		NAME##_alloc, NAME##_free, bbmemory_increase)
+
+#define BVECTOR_ARENA(BV, ELEMENT, NAME) \
+	BVECTOR(BV, ELEMENT, NAME##_alloc, NAME##_free, bbmemory_increase)
+
+/*
+ * The alignment is in bytes (a power of two, e.g. 64 for a cache line).
+ * There is no Forward Vector variant: its elements end the block,
+ * so the front element is not aligned.
+ */
+#define BVECTOR_ALIGNED_DEFAULT_IMPLEMENTATION(BV, ELEMENT, ALIGN) \
+	BBMEMORY_ALIGNED(BV##_aligned, ALIGN); \
+	BVECTOR_IMPLEMENTATION(BV, ELEMENT, \
+		BV##_aligned_alloc, BV##_aligned_free, bbmemory_increase)
+
+#define BVECTOR_ALIGNED_DEFAULT(BV, ELEMENT, ALIGN) \
+	BBMEMORY_ALIGNED(BV##_aligned, ALIGN); \
+	BVECTOR(BV, ELEMENT, \
+		BV##_aligned_alloc, BV##_aligned_free, bbmemory_increase)
+
+#ifdef BBMEMORY_MMAP
+
+#define BVECTOR_MMAP_DEFAULT_IMPLEMENTATION(BV, ELEMENT) \
+	BVECTOR_REALLOC_IMPLEMENTATION(BV, ELEMENT, \
+		bbmemory_mmap_realloc, bbmemory_mmap_free, bbmemory_increase)
+
+#define BVECTOR_MMAP_DEFAULT(BV, ELEMENT) \
+	BVECTOR_REALLOC(BV, ELEMENT, \
+		bbmemory_mmap_realloc, bbmemory_mmap_free, bbmemory_increase)
+
+#endif
+
+#define BVECTOR_POOL_IMPLEMENTATION(BV, ELEMENT) \
 	BVECTOR_IMPLEMENTATION(BV, ELEMENT, \
+		bbmemory_pool_alloc, bbmemory_pool_free, bbmemory_increase)
+
+#define BVECTOR_POOL(BV, ELEMENT) \
+	BVECTOR(BV, ELEMENT, \
+		bbmemory_pool_alloc, bbmemory_pool_free, bbmemory_increase)
+
+#define BVECTOR_SMALL_DEFAULT_IMPLEMENTATION(BV, ELEMENT, N) \
+	BVECTOR_SMALL_IMPLEMENTATION(BV, ELEMENT, N, \
 		bbmemory_alloc, free, bbmemory_increase)
 
-#define BVECTOR_DEFAULT(BV, ELEMENT) \
-	BVECTOR(BV, ELEMENT, bbmemory_alloc, free, bbmemory_increase)
+#define BVECTOR_SMALL_DEFAULT(BV, ELEMENT, N) \
+	BVECTOR_SMALL(BV, ELEMENT, N, bbmemory_alloc, free, bbmemory_increase)
+
+#define BVECTOR_SHRINK_DEFAULT_IMPLEMENTATION(BV, ELEMENT) \
+	BVECTOR_SHRINK_IMPLEMENTATION(BV, ELEMENT, bbmemory_decrease)
+
+#define BVECTOR_SHRINK_DEFAULT(BV, ELEMENT) \
+	BVECTOR_SHRINK(BV, ELEMENT, bbmemory_decrease)
+
+#define BVECTOR_TRY_DEFAULT_IMPLEMENTATION(BV, ELEMENT) \
+	BVECTOR_TRY_REALLOC_IMPLEMENTATION(BV, ELEMENT, \
+		bbmemory_tryrealloc, bbmemory_tryincrease)
+
+#define BVECTOR_TRY_DEFAULT(BV, ELEMENT) \
+	BVECTOR_TRY_REALLOC(BV, ELEMENT, \
+		bbmemory_tryrealloc, bbmemory_tryincrease)
+
+/* Backward Vector with the Priority Queue appendix. */
+
+#define PQUEUE_DEFAULT_IMPLEMENTATION(BV, ELEMENT, LESS) \
+	BVECTOR_DEFAULT_IMPLEMENTATION(BV, ELEMENT); \
+	PQUEUE_IMPLEMENTATION(BV, ELEMENT, LESS)
+
+#define PQUEUE_DEFAULT(BV, ELEMENT, LESS) \
+	BVECTOR_DEFAULT(BV, ELEMENT); \
+	PQUEUE(BV, ELEMENT, LESS)
 
 /* Forward Vector. */
 
@@ -61,6 +888,117 @@ static BBUNUSED size_t bbmemory_increase(size_t cap)
 #define FVECTOR_DEFAULT(FV, ELEMENT) \
 	FVECTOR(FV, ELEMENT, bbmemory_alloc, free, bbmemory_increase)
 
+#define FVECTOR_ARENA_IMPLEMENTATION(FV, ELEMENT, NAME) \
+	FVECTOR_IMPLEMENTATION(FV, ELEMENT, \
+		NAME##_alloc, NAME##_free, bbmemory_increase)
+
+#define FVECTOR_ARENA(FV, ELEMENT, NAME) \
+	FVECTOR(FV, ELEMENT, NAME##_alloc, NAME##_free, bbmemory_increase)
+
+#define FVECTOR_POOL_IMPLEMENTATION(FV, ELEMENT) \
+	FVECTOR_IMPLEMENTATION(FV, ELEMENT, \
+		bbmemory_pool_alloc, bbmemory_pool_free, bbmemory_increase)
+
+#define FVECTOR_POOL(FV, ELEMENT) \
+	FVECTOR(FV, ELEMENT, \
+		bbmemory_pool_alloc, bbmemory_pool_free, bbmemory_increase)
+
+#define FVECTOR_SHRINK_DEFAULT_IMPLEMENTATION(FV, ELEMENT) \
+	FVECTOR_SHRINK_IMPLEMENTATION(FV, ELEMENT, bbmemory_decrease)
+
+#define FVECTOR_SHRINK_DEFAULT(FV, ELEMENT) \
+	FVECTOR_SHRINK(FV, ELEMENT, bbmemory_decrease)
+
+#define FVECTOR_TRY_DEFAULT_IMPLEMENTATION(FV, ELEMENT) \
+	FVECTOR_TRY_IMPLEMENTATION(FV, ELEMENT, \
+		bbmemory_tryalloc, free, bbmemory_tryincrease)
+
+#define FVECTOR_TRY_DEFAULT(FV, ELEMENT) \
+	FVECTOR_TRY(FV, ELEMENT, bbmemory_tryalloc, free, bbmemory_tryincrease)
+
+/* Queue Vector. */
+
+#define QVECTOR_DEFAULT_IMPLEMENTATION(QV, ELEMENT) \
+	QVECTOR_IMPLEMENTATION(QV, ELEMENT, \
+		bbmemory_alloc, free, bbmemory_increase)
+
+#define QVECTOR_DEFAULT(QV, ELEMENT) \
+	QVECTOR(QV, ELEMENT, bbmemory_alloc, free, bbmemory_increase)
+
+#define QVECTOR_ARENA_IMPLEMENTATION(QV, ELEMENT, NAME) \
+	QVECTOR_IMPLEMENTATION(QV, ELEMENT, \
+		NAME##_alloc, NAME##_free, bbmemory_increase)
+
+#define QVECTOR_ARENA(QV, ELEMENT, NAME) \
+	QVECTOR(QV, ELEMENT, NAME##_alloc, NAME##_free, bbmemory_increase)
+
+#define QVECTOR_POOL_IMPLEMENTATION(QV, ELEMENT) \
+	QVECTOR_IMPLEMENTATION(QV, ELEMENT, \
+		bbmemory_pool_alloc, bbmemory_pool_free, bbmemory_increase)
+
+#define QVECTOR_POOL(QV, ELEMENT) \
+	QVECTOR(QV, ELEMENT, \
+		bbmemory_pool_alloc, bbmemory_pool_free, bbmemory_increase)
+
+/****************************************
+ * Hash Tables.
+ ****************************************/
+
+#define HASHMAP_DEFAULT_IMPLEMENTATION(HM, KEY, VALUE, HASH, EQ) \
+	HASHMAP_IMPLEMENTATION(HM, KEY, VALUE, HASH, EQ, bbmemory_alloc, free)
+
+#define HASHMAP_DEFAULT(HM, KEY, VALUE, HASH, EQ) \
+	HASHMAP(HM, KEY, VALUE, HASH, EQ, bbmemory_alloc, free)
+
+#define HASHSET_DEFAULT_IMPLEMENTATION(HS, KEY, HASH, EQ) \
+	HASHSET_IMPLEMENTATION(HS, KEY, HASH, EQ, bbmemory_alloc, free)
+
+#define HASHSET_DEFAULT(HS, KEY, HASH, EQ) \
+	HASHSET(HS, KEY, HASH, EQ, bbmemory_alloc, free)
+
+/****************************************
+ * Structure of Arrays.
+ ****************************************/
+
+/* The blocks are aligned to BBSOA_ALIGN, so the columns are too. */
+#define SOA_DEFAULT_IMPLEMENTATION(SA, FIELDS) \
+	BBMEMORY_ALIGNED(SA##_aligned, BBSOA_ALIGN); \
+	SOA_IMPLEMENTATION(SA, FIELDS, \
+		SA##_aligned_alloc, SA##_aligned_free, bbmemory_increase)
+
+#define SOA_DEFAULT(SA, FIELDS) \
+	BBMEMORY_ALIGNED(SA##_aligned, BBSOA_ALIGN); \
+	SOA(SA, FIELDS, SA##_aligned_alloc, SA##_aligned_free, bbmemory_increase)
+
+/****************************************
+ * Concurrent containers (`ring.h`, `deque.h` and `svector.h`
+ * are not included here, as they require atomics).
+ ****************************************/
+
+#define SPSCRING_DEFAULT_IMPLEMENTATION(RB, ELEMENT) \
+	SPSCRING_IMPLEMENTATION(RB, ELEMENT, bbmemory_alloc, free)
+
+#define SPSCRING_DEFAULT(RB, ELEMENT) \
+	SPSCRING(RB, ELEMENT, bbmemory_alloc, free)
+
+#define MPMCRING_DEFAULT_IMPLEMENTATION(RB, ELEMENT) \
+	MPMCRING_IMPLEMENTATION(RB, ELEMENT, bbmemory_alloc, free)
+
+#define MPMCRING_DEFAULT(RB, ELEMENT) \
+	MPMCRING(RB, ELEMENT, bbmemory_alloc, free)
+
+#define WSDEQUE_DEFAULT_IMPLEMENTATION(DQ, ELEMENT) \
+	WSDEQUE_IMPLEMENTATION(DQ, ELEMENT, bbmemory_alloc, free)
+
+#define WSDEQUE_DEFAULT(DQ, ELEMENT) \
+	WSDEQUE(DQ, ELEMENT, bbmemory_alloc, free)
+
+#define SVECTOR_DEFAULT_IMPLEMENTATION(SV, ELEMENT) \
+	SVECTOR_IMPLEMENTATION(SV, ELEMENT, bbmemory_alloc, free)
+
+#define SVECTOR_DEFAULT(SV, ELEMENT) \
+	SVECTOR(SV, ELEMENT, bbmemory_alloc, free)
+
 /****************************************
  * Legacy.
  ****************************************/
@@ -0,0 +1,273 @@
+#ifndef BBMACRO_PARALLEL_H_
+#define BBMACRO_PARALLEL_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <bbmacro/static.h>
+#include <bbmacro/vector.h>
+#include <bbmacro/algo.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * Parallel appendix to the Backward Vector (POSIX threads).
+ * 1. A pool keeps the worker threads between the calls. A call splits
+ *    the vector into chunks, and the pool threads (the calling one
+ *    as well) process the chunks until there are none left.
+ * 2. The `psort` procedure sorts the chunks with `sort` (see `algo.h`)
+ *    and merges the sorted runs pairwise, a round of merges at a time.
+ *    It is not stable and needs a temporary array of `len` elements.
+ * 3. The `pfor` procedure calls a procedure on every chunk.
+ * 4. Only one call may run on a pool at a time.
+ */
+
+/*
+ * How to use the pool?
+ * #define item_less(item1, item2) ((item1).id < (item2).id)
+ * BVECTOR_DEFAULT(items, struct item);
+ * BVECTOR_ALGO(items, struct item, item_less);
+ * BVECTOR_PARALLEL(items, struct item, item_less);
+ * struct bbparallel_pool pool;
+ * bbparallel_init(0, &pool); ... all the processors ...
+ * items_pfor(update, &state, &pool, &v);
+ * items_psort(tmp, &pool, &v);
+ * bbparallel_fini(&pool);
+ */
+
+/* Maximum number of threads in a pool. */
+#define BBPARALLEL_THREADS 64
+
+/* Number of chunks of `pfor` per thread (for the balance). */
+#define BBPARALLEL_SPLIT 4
+
+/* Minimum number of elements in a chunk. */
+#define BBPARALLEL_GRAIN 4096
+
+/* Pool of threads. */
+struct bbparallel_pool {
+	pthread_t thread[BBPARALLEL_THREADS - 1]; /* Workers. */
+	int threads; /* Number of threads (with the calling one). */
+	pthread_mutex_t mutex;
+	pthread_cond_t start, done;
+	void (*fn)(size_t task, void *arg); /* Current job. */
+	void *arg;
+	size_t tasks, next, finished; /* Tasks of the job. */
+	unsigned long job; /* Number of the job. */
+	int stop;
+};
+
+/*
+ * Run the tasks of the current job. The mutex must be locked.
+ */
+static BBUNUSED void bbparallel_work_(struct bbparallel_pool *pool)
+{
+	void (*fn)(size_t task, void *arg) = pool->fn;
+	void *arg = pool->arg;
+
+	while (pool->next < pool->tasks) {
+		size_t task = pool->next++;
+		pthread_mutex_unlock(&pool->mutex);
+		fn(task, arg);
+		pthread_mutex_lock(&pool->mutex);
+		if (++pool->finished == pool->tasks)
+			pthread_cond_broadcast(&pool->done);
+	}
+}
+
+static BBUNUSED void *bbparallel_worker_(void *arg)
+{
+	struct bbparallel_pool *pool = arg;
+	unsigned long job = 0;
+
+	pthread_mutex_lock(&pool->mutex);
+	for (;;) {
+		while (!pool->stop && pool->job == job)
+			pthread_cond_wait(&pool->start, &pool->mutex);
+		if (pool->stop)
+			break;
+		job = pool->job;
+		bbparallel_work_(pool);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	return NULL;
+}
+
+/*
+ * Start a pool of `threads` threads (with the calling one).
+ * Zero or less means the number of online processors.
+ * Return the number of threads (fewer if some could not be created).
+ */
+static BBUNUSED int bbparallel_init(int threads, struct bbparallel_pool *pool)
+{
+	if (threads <= 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		if (threads <= 0)
+			threads = 1;
+	}
+	if (threads > BBPARALLEL_THREADS)
+		threads = BBPARALLEL_THREADS;
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+	pool->tasks = pool->next = pool->finished = 0;
+	pool->job = 0;
+	pool->stop = 0;
+	for (pool->threads = 1; pool->threads < threads; pool->threads++)
+		if (pthread_create(&pool->thread[pool->threads - 1], NULL,
+			bbparallel_worker_, pool))
+			break;
+	return pool->threads;
+}
+
+/*
+ * Stop the threads of a pool.
+ */
+static BBUNUSED void bbparallel_fini(struct bbparallel_pool *pool)
+{
+	int num;
+
+	pthread_mutex_lock(&pool->mutex);
+	pool->stop = 1;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->mutex);
+	for (num = 0; num < pool->threads - 1; num++)
+		pthread_join(pool->thread[num], NULL);
+	pthread_cond_destroy(&pool->done);
+	pthread_cond_destroy(&pool->start);
+	pthread_mutex_destroy(&pool->mutex);
+}
+
+/*
+ * Call `fn(task, arg)` for every task in [0, tasks) on the threads
+ * of a pool. Return when all the calls have returned.
+ */
+static BBUNUSED void bbparallel_run(size_t tasks,
+	void (*fn)(size_t task, void *arg), void *arg,
+	struct bbparallel_pool *pool)
+{
+	if (tasks == 0)
+		return;
+	pthread_mutex_lock(&pool->mutex);
+	pool->fn = fn;
+	pool->arg = arg;
+	pool->tasks = tasks;
+	pool->next = 0;
+	pool->finished = 0;
+	pool->job++;
+	pthread_cond_broadcast(&pool->start);
+	bbparallel_work_(pool);
+	while (pool->finished < pool->tasks)
+		pthread_cond_wait(&pool->done, &pool->mutex);
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+/****************************************
+ * Parallel interface.
+ ****************************************/
+
+/*
+ * Parallel procedures.
+ * The `psort` procedure requires the Algorithms appendix (`sort`).
+ * FN(at, num, arg) of `pfor` is called on the chunks of the vector.
+ */
+#define BVECTOR_PARALLEL_DECLARATIONS(BV, ELEMENT, PREFIX) \
+\
+PREFIX void BV##_psort(ELEMENT *tmp, struct bbparallel_pool *pool, \
+	struct BV *bv); \
+PREFIX void BV##_pfor(void (*fn)(ELEMENT *at, size_t num, void *arg), \
+	void *arg, struct bbparallel_pool *pool, struct BV *bv); \
+bbstatic_semicolon
+
+/****************************************
+ * Parallel implementation.
+ ****************************************/
+
+/* Parallel procedures. */
+#define BVECTOR_PARALLEL_IMPLEMENTATION(BV, ELEMENT, LESS) \
+\
+struct BV##_pjob_ { \
+	ELEMENT *src, *dst; /* Runs to merge and their destination. */ \
+	size_t len, chunk; /* Length and size of a chunk (or a run). */ \
+	void (*fn)(ELEMENT *at, size_t num, void *arg); \
+	void *arg; \
+}; \
+static BBUNUSED void BV##_psort_(size_t task, void *arg) \
+{	struct BV##_pjob_ *job = arg; \
+	struct BV run; \
+	size_t first = task * job->chunk; \
+	run.at = job->src + first; \
+	run.len = run.cap = job->len - first < job->chunk ? \
+		job->len - first : job->chunk; \
+	BV##_sort(&run); \
+} \
+static BBUNUSED void BV##_pmerge_(size_t task, void *arg) \
+{	struct BV##_pjob_ *job = arg; \
+	size_t first = task * job->chunk * 2, len = job->len; \
+	size_t mid = len - first < job->chunk ? len : first + job->chunk; \
+	size_t last = len - mid < job->chunk ? len : mid + job->chunk; \
+	ELEMENT *src = job->src, *dst = job->dst + first; \
+	size_t left = first, right = mid; \
+	while (left < mid && right < last) \
+		*dst++ = LESS(src[right], src[left]) ? \
+			src[right++] : src[left++]; \
+	memcpy(dst, &src[left], sizeof(ELEMENT) * (mid - left)); \
+	memcpy(dst + (mid - left), &src[right], \
+		sizeof(ELEMENT) * (last - right)); \
+} \
+static BBUNUSED void BV##_pfor_(size_t task, void *arg) \
+{	struct BV##_pjob_ *job = arg; \
+	size_t first = task * job->chunk; \
+	job->fn(job->src + first, job->len - first < job->chunk ? \
+		job->len - first : job->chunk, job->arg); \
+} \
+void BV##_psort(ELEMENT *tmp, struct bbparallel_pool *pool, \
+	struct BV *bv) \
+{	struct BV##_pjob_ job; \
+	size_t tasks; \
+	job.len = bv->len; \
+	job.chunk = (job.len + pool->threads - 1) / pool->threads; \
+	if (pool->threads == 1 || job.chunk < BBPARALLEL_GRAIN) { \
+		BV##_sort(bv); \
+		return; \
+	} \
+	job.src = bv->at; \
+	job.dst = tmp; \
+	tasks = (job.len + job.chunk - 1) / job.chunk; \
+	bbparallel_run(tasks, BV##_psort_, &job, pool); \
+	for (; job.chunk < job.len; job.chunk *= 2) { \
+		ELEMENT *swap = job.src; \
+		tasks = (job.len + job.chunk * 2 - 1) / (job.chunk * 2); \
+		bbparallel_run(tasks, BV##_pmerge_, &job, pool); \
+		job.src = job.dst; \
+		job.dst = swap; \
+	} \
+	if (job.src != bv->at) \
+		memcpy(bv->at, job.src, sizeof(ELEMENT) * job.len); \
+} \
+void BV##_pfor(void (*fn)(ELEMENT *at, size_t num, void *arg), \
+	void *arg, struct bbparallel_pool *pool, struct BV *bv) \
+{	struct BV##_pjob_ job; \
+	size_t chunks = (size_t)pool->threads * BBPARALLEL_SPLIT; \
+	job.src = bv->at; \
+	job.len = bv->len; \
+	job.chunk = (job.len + chunks - 1) / chunks; \
+	if (job.chunk < BBPARALLEL_GRAIN) \
+		job.chunk = BBPARALLEL_GRAIN; \
+	job.fn = fn; \
+	job.arg = arg; \
+	bbparallel_run((job.len + job.chunk - 1) / job.chunk, \
+		BV##_pfor_, &job, pool); \
+} \
+bbstatic_semicolon
+
+/* Parallel full. */
+#define BVECTOR_PARALLEL(BV, ELEMENT, LESS) \
+	BVECTOR_PARALLEL_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	BVECTOR_PARALLEL_IMPLEMENTATION(BV, ELEMENT, LESS)
+
+#endif
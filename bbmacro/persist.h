@@ -0,0 +1,258 @@
+#ifndef BBMACRO_PERSIST_H_
+#define BBMACRO_PERSIST_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <bbmacro/static.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * Persistence appendix to the Backward Vector (POSIX).
+ * 1. The `save` procedure writes a file: a header of BBPERSIST_HEADER
+ *    bytes (the magic, the size of an element, the length, the byte
+ *    order and a checksum) followed by the raw elements. The file is
+ *    written under a temporary name and then renamed, so a reader never
+ *    sees it half-written.
+ * 2. The `mmapload` procedure maps the file read-only and points the
+ *    vector into the mapping: nothing is read or copied until the pages
+ *    are touched. Only the header is checked; the `verify` procedure
+ *    checks the elements against the checksum (touching all of them).
+ * 3. The elements must be plain data (no pointers) of the same layout
+ *    for the writer and for the reader.
+ * 4. A loaded vector is read-only: do not modify it or pass it to
+ *    automatic procedures. Release it with `munload`.
+ */
+
+/*
+ * How to use the procedures?
+ * BVECTOR_DEFAULT(table, struct entry);
+ * BVECTOR_PERSIST(table, struct entry);
+ * ... a builder ...
+ * if (table_save("table.bin", &v)) ... error ...
+ * ... a service ...
+ * if (table_mmapload("table.bin", &v)) ... error ...
+ * ... read the elements ...
+ * table_munload(&v);
+ */
+
+/* Size of the file header (keeps the elements aligned). */
+#define BBPERSIST_HEADER 64
+
+/* Magic bytes in the beginning of a file. */
+#define BBPERSIST_MAGIC "BBVECTOR"
+
+/* Byte order of the elements (stored in the header). */
+#define BBPERSIST_LITTLE 1
+#define BBPERSIST_BIG 2
+
+/*
+ * Byte order of the host (the elements are stored in it).
+ */
+static BBUNUSED unsigned char bbpersist_order(void)
+{
+	unsigned int one = 1;
+
+	return *(unsigned char *)&one ? BBPERSIST_LITTLE : BBPERSIST_BIG;
+}
+
+/*
+ * Store a number in 8 bytes (the least significant first).
+ */
+static BBUNUSED void bbpersist_put(unsigned char *at, size_t num)
+{
+	int pos;
+
+	for (pos = 0; pos < 8; pos++) {
+		at[pos] = (unsigned char)(num & 0xFF);
+		num = num >> 4 >> 4;
+	}
+}
+
+/*
+ * Load a number of 8 bytes. Return `(size_t)-1` if it does not fit.
+ */
+static BBUNUSED size_t bbpersist_get(const unsigned char *at)
+{
+	size_t num = 0;
+	int pos;
+
+	for (pos = 7; pos >= 0; pos--) {
+		if ((size_t)pos >= sizeof(size_t) && at[pos])
+			return (size_t)-1;
+		num = num << 4 << 4 | at[pos];
+	}
+	return num;
+}
+
+/*
+ * Checksum of the elements (32-bit FNV-1a).
+ */
+static BBUNUSED unsigned long bbpersist_checksum(const void *at, size_t len)
+{
+	const unsigned char *ptr = at, *end = ptr + len;
+	unsigned long hash = 2166136261UL;
+
+	while (ptr != end)
+		hash = ((hash ^ *ptr++) * 16777619UL) & 0xFFFFFFFFUL;
+	return hash;
+}
+
+/*
+ * Write the elements into a file. Return 0 on success, -1 on failure.
+ */
+static BBUNUSED int bbpersist_save(const char *path, const void *at,
+	size_t len, size_t size)
+{
+	unsigned char header[BBPERSIST_HEADER];
+	size_t pathlen = strlen(path);
+	char *tmp = malloc(pathlen + 5);
+	FILE *file;
+	int err = 0;
+
+	if (!tmp)
+		return -1;
+	memcpy(tmp, path, pathlen);
+	memcpy(tmp + pathlen, ".tmp", 5);
+	memset(header, 0, sizeof(header));
+	memcpy(header, BBPERSIST_MAGIC, 8);
+	bbpersist_put(header + 8, size);
+	bbpersist_put(header + 16, len);
+	bbpersist_put(header + 24, bbpersist_checksum(at, len * size));
+	header[32] = bbpersist_order();
+
+	file = fopen(tmp, "wb");
+	if (!file) {
+		free(tmp);
+		return -1;
+	}
+	if (fwrite(header, 1, sizeof(header), file) != sizeof(header))
+		err = -1;
+	if (!err && len && fwrite(at, size, len, file) != len)
+		err = -1;
+	if (fclose(file))
+		err = -1;
+	if (!err && rename(tmp, path))
+		err = -1;
+	if (err)
+		remove(tmp);
+	free(tmp);
+	return err;
+}
+
+/*
+ * Map the elements of a file. Return NULL on failure.
+ */
+static BBUNUSED void *bbpersist_load(const char *path, size_t size,
+	size_t *len)
+{
+	const unsigned char *header;
+	struct stat st;
+	void *map;
+	size_t total;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0)
+		return NULL;
+	if (fstat(fd, &st) || st.st_size < BBPERSIST_HEADER ||
+		(off_t)(size_t)st.st_size != st.st_size) {
+		close(fd);
+		return NULL;
+	}
+	total = (size_t)st.st_size;
+	map = mmap(NULL, total, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return NULL;
+	header = map;
+	*len = bbpersist_get(header + 16);
+	if (memcmp(header, BBPERSIST_MAGIC, 8) ||
+		bbpersist_get(header + 8) != size ||
+		header[32] != bbpersist_order() ||
+		*len > (total - BBPERSIST_HEADER) / size ||
+		*len * size != total - BBPERSIST_HEADER) {
+		munmap(map, total);
+		return NULL;
+	}
+	return (char *)map + BBPERSIST_HEADER;
+}
+
+/*
+ * Unmap the elements.
+ */
+static BBUNUSED void bbpersist_unload(void *at, size_t len, size_t size)
+{
+	munmap((char *)at - BBPERSIST_HEADER, BBPERSIST_HEADER + len * size);
+}
+
+/*
+ * Check the mapped elements against the checksum.
+ * Return 0 if they match, -1 otherwise.
+ */
+static BBUNUSED int bbpersist_verify(const void *at, size_t len, size_t size)
+{
+	const unsigned char *header = (const unsigned char *)at -
+		BBPERSIST_HEADER;
+	unsigned long checksum = bbpersist_checksum(at, len * size);
+
+	return bbpersist_get(header + 24) == checksum ? 0 : -1;
+}
+
+/****************************************
+ * Persistence interface.
+ ****************************************/
+
+/*
+ * Persistence procedures.
+ * The procedures return 0 on success and -1 on failure.
+ * The `verify` procedure requires the vector to be loaded.
+ */
+#define BVECTOR_PERSIST_DECLARATIONS(BV, ELEMENT, PREFIX) \
+\
+PREFIX int BV##_save(const char *path, struct BV *bv); \
+PREFIX int BV##_mmapload(const char *path, struct BV *bv); \
+PREFIX void BV##_munload(struct BV *bv); \
+PREFIX int BV##_verify(struct BV *bv); \
+bbstatic_semicolon
+
+/****************************************
+ * Persistence implementation.
+ ****************************************/
+
+/* Persistence procedures. */
+#define BVECTOR_PERSIST_IMPLEMENTATION(BV, ELEMENT) \
+\
+int BV##_save(const char *path, struct BV *bv) \
+{	return bbpersist_save(path, bv->at, bv->len, sizeof(ELEMENT)); \
+} \
+int BV##_mmapload(const char *path, struct BV *bv) \
+{	size_t len; \
+	ELEMENT *at = bbpersist_load(path, sizeof(ELEMENT), &len); \
+	if (!at) \
+		return -1; \
+	bv->at = at; \
+	bv->len = len; \
+	bv->cap = len; \
+	return 0; \
+} \
+void BV##_munload(struct BV *bv) \
+{	bbpersist_unload(bv->at, bv->len, sizeof(ELEMENT)); \
+} \
+int BV##_verify(struct BV *bv) \
+{	return bbpersist_verify(bv->at, bv->len, sizeof(ELEMENT)); \
+} \
+bbstatic_semicolon
+
+/* Persistence full. */
+#define BVECTOR_PERSIST(BV, ELEMENT) \
+	BVECTOR_PERSIST_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	BVECTOR_PERSIST_IMPLEMENTATION(BV, ELEMENT)
+
+#endif
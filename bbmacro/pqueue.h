@@ -0,0 +1,161 @@
+#ifndef BBMACRO_PQUEUE_H_
+#define BBMACRO_PQUEUE_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <bbmacro/static.h>
+#include <bbmacro/vector.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * Priority queue (binary min-heap) appendix to the Backward Vector.
+ * 1. The heap is kept in the elements of a vector, the least one first.
+ *    The vector procedures may still be used to read the elements
+ *    (e.g. to find the position of an element to decrease).
+ * 2. LESS(value1, value2) returns non-zero if the first element goes first.
+ *    It may be a macro, so the comparisons are inlined.
+ * 3. The core procedures require the Backward Vector core procedures.
+ *    The automatic procedures require the automatic ones as well
+ *    and grow the vector the same way as they do.
+ */
+
+/*
+ * How to call the macro?
+ * #define timer_less(timer1, timer2) ((timer1).time < (timer2).time)
+ * BVECTOR_DEFAULT(timers, struct timer);
+ * PQUEUE(timers, struct timer, timer_less);
+ * ... or everything at once (see `memory.h`) ...
+ * PQUEUE_DEFAULT(timers, struct timer, timer_less);
+ */
+
+/*
+ * How to use the queue?
+ * struct timers q;
+ * timers_ainit(0, &q);
+ * timers_aheappush(timer, &q);
+ * while (q.len) {
+ *     ... timers_heaptop(&q) ...
+ *     timers_heappop(&q);
+ * }
+ * timers_afini(&q);
+ */
+
+/****************************************
+ * Priority Queue interface.
+ ****************************************/
+
+/*
+ * Priority Queue core procedures.
+ * The `heapify` procedure orders the whole vector in linear time.
+ * The `heappush` procedure requires the vector not to be full.
+ * The `heapdecrease` procedure restores the order after the element
+ * at the position has been made less; `heaperase` removes the element.
+ */
+#define PQUEUE_CORE_DECLARATIONS(BV, ELEMENT, PREFIX) \
+\
+PREFIX void BV##_heapify(struct BV *bv); \
+PREFIX void BV##_heappush(ELEMENT value, struct BV *bv); \
+PREFIX void BV##_heappop(struct BV *bv); \
+PREFIX ELEMENT *BV##_heaptop(struct BV *bv); \
+PREFIX void BV##_heapdecrease(size_t num, struct BV *bv); \
+PREFIX void BV##_heaperase(size_t num, struct BV *bv); \
+bbstatic_semicolon
+
+/* Priority Queue automatic memory management appendix. */
+#define PQUEUE_AUTO_DECLARATIONS(BV, ELEMENT, PREFIX) \
+\
+PREFIX void BV##_aheappush(ELEMENT value, struct BV *bv); \
+bbstatic_semicolon
+
+/* Priority Queue automatic memory management procedures. */
+#define PQUEUE_DECLARATIONS(BV, ELEMENT, PREFIX) \
+	PQUEUE_CORE_DECLARATIONS(BV, ELEMENT, PREFIX); \
+	PQUEUE_AUTO_DECLARATIONS(BV, ELEMENT, PREFIX)
+
+/****************************************
+ * Priority Queue implementation.
+ ****************************************/
+
+/* Priority Queue core procedures. */
+#define PQUEUE_CORE_IMPLEMENTATION(BV, ELEMENT, LESS) \
+\
+static BBUNUSED void BV##_siftup_(size_t num, struct BV *bv) \
+{	ELEMENT value = bv->at[num]; \
+	while (num > 0) { \
+		size_t parent = (num - 1) / 2; \
+		if (!(LESS(value, bv->at[parent]))) \
+			break; \
+		bv->at[num] = bv->at[parent]; \
+		num = parent; \
+	} \
+	bv->at[num] = value; \
+} \
+static BBUNUSED void BV##_siftdown_(size_t num, struct BV *bv) \
+{	ELEMENT value = bv->at[num]; \
+	size_t child; \
+	while ((child = num * 2 + 1) < bv->len) { \
+		if (child + 1 < bv->len && LESS(bv->at[child + 1], bv->at[child])) \
+			child++; \
+		if (!(LESS(bv->at[child], value))) \
+			break; \
+		bv->at[num] = bv->at[child]; \
+		num = child; \
+	} \
+	bv->at[num] = value; \
+} \
+void BV##_heapify(struct BV *bv) \
+{	size_t num = bv->len / 2; \
+	while (num-- > 0) \
+		BV##_siftdown_(num, bv); \
+} \
+void BV##_heappush(ELEMENT value, struct BV *bv) \
+{	BV##_pushback(value, bv); \
+	BV##_siftup_(bv->len - 1, bv); \
+} \
+void BV##_heappop(struct BV *bv) \
+{	BV##_heaperase(0, bv); \
+} \
+ELEMENT *BV##_heaptop(struct BV *bv) \
+{	return &bv->at[0]; \
+} \
+void BV##_heapdecrease(size_t num, struct BV *bv) \
+{	BV##_siftup_(num, bv); \
+} \
+void BV##_heaperase(size_t num, struct BV *bv) \
+{	bv->at[num] = *BV##_back(bv); \
+	BV##_popback(bv); \
+	if (num >= bv->len) \
+		return; \
+	if (num > 0 && LESS(bv->at[num], bv->at[(num - 1) / 2])) \
+		BV##_siftup_(num, bv); \
+	else \
+		BV##_siftdown_(num, bv); \
+} \
+bbstatic_semicolon
+
+/* Priority Queue automatic memory management appendix. */
+#define PQUEUE_AUTO_IMPLEMENTATION(BV, ELEMENT) \
+\
+void BV##_aheappush(ELEMENT value, struct BV *bv) \
+{	BV##_apushback(value, bv); \
+	BV##_siftup_(bv->len - 1, bv); \
+} \
+bbstatic_semicolon
+
+/* Priority Queue automatic memory management procedures. */
+#define PQUEUE_IMPLEMENTATION(BV, ELEMENT, LESS) \
+	PQUEUE_CORE_IMPLEMENTATION(BV, ELEMENT, LESS); \
+	PQUEUE_AUTO_IMPLEMENTATION(BV, ELEMENT)
+
+/* Priority Queue core full. */
+#define PQUEUE_CORE(BV, ELEMENT, LESS) \
+	PQUEUE_CORE_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	PQUEUE_CORE_IMPLEMENTATION(BV, ELEMENT, LESS)
+
+/* Priority Queue automatic memory management full. */
+#define PQUEUE(BV, ELEMENT, LESS) \
+	PQUEUE_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	PQUEUE_IMPLEMENTATION(BV, ELEMENT, LESS)
+
+#endif
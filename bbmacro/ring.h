@@ -0,0 +1,390 @@
+#ifndef BBMACRO_RING_H_
+#define BBMACRO_RING_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <stddef.h>
+#include <string.h>
+#include <bbmacro/static.h>
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__) /* C11. */
+#include <stdatomic.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/atomic.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * Lock-free ring buffers (bounded queues) for passing elements
+ * between threads.
+ * 1. The capacity is a power of two and never changes.
+ * 2. The positions are counters that only grow (wrapping around
+ *    `size_t`); an element lives at the position modulo the capacity.
+ * 3. The data written by different threads is padded to separate
+ *    cache lines (see `atomic.h`).
+ * 4. Core procedures provide manual memory management only.
+ *    The automatic appendix only allocates and frees the memory.
+ * 5. Note the ring itself is always the last argument of a procedure.
+ */
+
+/*
+ * How to use the single-producer/single-consumer ring?
+ * SPSCRING_DEFAULT(myring, struct job);
+ * struct myring r;
+ * myring_ainit(1024, &r);
+ * ... producer thread ...
+ * while (myring_push(job, &r))
+ *     ... full, retry later ...
+ * ... consumer thread ...
+ * if (!myring_pop(&job, &r))
+ *     ... got a job ...
+ * ... after both threads are done ...
+ * myring_afini(&r);
+ *
+ * The multi-producer/multi-consumer ring is used the same way,
+ * from any number of threads (MPMCRING_DEFAULT, without `pushn`/`popn`).
+ */
+
+/****************************************
+ * Single-Producer/Single-Consumer Ring interface.
+ ****************************************/
+
+/*
+ * Single-Producer/Single-Consumer Ring structure.
+ * Each side keeps a copy of the other side's position, so that the shared
+ * position is loaded only when the copy says the ring is full (or empty).
+ */
+#define SPSCRING_STRUCT(RB, ELEMENT) \
+\
+struct RB { \
+	size_t cap; /* Capacity (a power of two). */ \
+	ELEMENT *at; /* Beginning of memory. */ \
+	char pad1[BBCACHELINE]; \
+	BBATOMIC(size_t) head; /* Position to pop (written by the consumer). */ \
+	size_t tailcopy; /* Copy of the tail (for the consumer). */ \
+	char pad2[BBCACHELINE]; \
+	BBATOMIC(size_t) tail; /* Position to push (written by the producer). */ \
+	size_t headcopy; /* Copy of the head (for the producer). */ \
+	char pad3[BBCACHELINE]; \
+}
+
+/*
+ * Single-Producer/Single-Consumer Ring core procedures.
+ * Only one thread may push and only one thread may pop at a time.
+ * The `push` and `pop` procedures return 0 on success and -1 if the ring
+ * is full (or empty). The `pushn` and `popn` procedures move up to `num`
+ * elements at once and return the number moved.
+ * The `len` procedure returns a snapshot, exact only for a single side.
+ */
+#define SPSCRING_CORE_DECLARATIONS(RB, ELEMENT, PREFIX) \
+\
+PREFIX void RB##_init(ELEMENT *array, size_t cap, struct RB *rb); \
+PREFIX ELEMENT *RB##_fini(struct RB *rb); \
+PREFIX size_t RB##_len(struct RB *rb); \
+\
+PREFIX int RB##_push(ELEMENT value, struct RB *rb); \
+PREFIX int RB##_pop(ELEMENT *value, struct RB *rb); \
+PREFIX size_t RB##_pushn(ELEMENT const *array, size_t num, struct RB *rb); \
+PREFIX size_t RB##_popn(ELEMENT *array, size_t num, struct RB *rb); \
+bbstatic_semicolon
+
+/*
+ * Single-Producer/Single-Consumer Ring automatic memory management appendix.
+ * The capacity is rounded up to a power of two.
+ */
+#define SPSCRING_AUTO_DECLARATIONS(RB, ELEMENT, PREFIX) \
+\
+PREFIX void RB##_ainit(size_t cap, struct RB *rb); \
+PREFIX void RB##_afini(struct RB *rb); \
+bbstatic_semicolon
+
+/* Single-Producer/Single-Consumer Ring automatic memory management. */
+#define SPSCRING_DECLARATIONS(RB, ELEMENT, PREFIX) \
+	SPSCRING_CORE_DECLARATIONS(RB, ELEMENT, PREFIX); \
+	SPSCRING_AUTO_DECLARATIONS(RB, ELEMENT, PREFIX)
+
+/* Single-Producer/Single-Consumer Ring core interface. */
+#define SPSCRING_CORE_INTERFACE(RB, ELEMENT, PREFIX) \
+	SPSCRING_STRUCT(RB, ELEMENT); \
+	SPSCRING_CORE_DECLARATIONS(RB, ELEMENT, PREFIX)
+
+/* Single-Producer/Single-Consumer Ring automatic memory management. */
+#define SPSCRING_INTERFACE(RB, ELEMENT, PREFIX) \
+	SPSCRING_STRUCT(RB, ELEMENT); \
+	SPSCRING_DECLARATIONS(RB, ELEMENT, PREFIX)
+
+/****************************************
+ * Single-Producer/Single-Consumer Ring implementation.
+ ****************************************/
+
+/* Single-Producer/Single-Consumer Ring core procedures. */
+#define SPSCRING_CORE_IMPLEMENTATION(RB, ELEMENT) \
+\
+void RB##_init(ELEMENT *array, size_t cap, struct RB *rb) \
+{	rb->cap = cap; \
+	rb->at = array; \
+	bbatomic_store(&rb->head, 0, BBATOMIC_RELAXED); \
+	bbatomic_store(&rb->tail, 0, BBATOMIC_RELAXED); \
+	rb->tailcopy = 0; \
+	rb->headcopy = 0; \
+} \
+ELEMENT *RB##_fini(struct RB *rb) \
+{	return rb->at; \
+} \
+size_t RB##_len(struct RB *rb) \
+{	size_t head = bbatomic_load(&rb->head, BBATOMIC_ACQUIRE); \
+	return bbatomic_load(&rb->tail, BBATOMIC_ACQUIRE) - head; \
+} \
+int RB##_push(ELEMENT value, struct RB *rb) \
+{	size_t tail = bbatomic_load(&rb->tail, BBATOMIC_RELAXED); \
+	if (tail - rb->headcopy == rb->cap) { \
+		rb->headcopy = bbatomic_load(&rb->head, BBATOMIC_ACQUIRE); \
+		if (tail - rb->headcopy == rb->cap) \
+			return -1; \
+	} \
+	rb->at[tail & (rb->cap - 1)] = value; \
+	bbatomic_store(&rb->tail, tail + 1, BBATOMIC_RELEASE); \
+	return 0; \
+} \
+int RB##_pop(ELEMENT *value, struct RB *rb) \
+{	size_t head = bbatomic_load(&rb->head, BBATOMIC_RELAXED); \
+	if (head == rb->tailcopy) { \
+		rb->tailcopy = bbatomic_load(&rb->tail, BBATOMIC_ACQUIRE); \
+		if (head == rb->tailcopy) \
+			return -1; \
+	} \
+	*value = rb->at[head & (rb->cap - 1)]; \
+	bbatomic_store(&rb->head, head + 1, BBATOMIC_RELEASE); \
+	return 0; \
+} \
+size_t RB##_pushn(ELEMENT const *array, size_t num, struct RB *rb) \
+{	size_t tail = bbatomic_load(&rb->tail, BBATOMIC_RELAXED); \
+	size_t pos = tail & (rb->cap - 1), first; \
+	if (num > rb->cap - (tail - rb->headcopy)) { \
+		rb->headcopy = bbatomic_load(&rb->head, BBATOMIC_ACQUIRE); \
+		if (num > rb->cap - (tail - rb->headcopy)) \
+			num = rb->cap - (tail - rb->headcopy); \
+	} \
+	if (num == 0) \
+		return 0; \
+	first = rb->cap - pos < num ? rb->cap - pos : num; \
+	memcpy(&rb->at[pos], array, sizeof(ELEMENT) * first); \
+	memcpy(rb->at, array + first, sizeof(ELEMENT) * (num - first)); \
+	bbatomic_store(&rb->tail, tail + num, BBATOMIC_RELEASE); \
+	return num; \
+} \
+size_t RB##_popn(ELEMENT *array, size_t num, struct RB *rb) \
+{	size_t head = bbatomic_load(&rb->head, BBATOMIC_RELAXED); \
+	size_t pos = head & (rb->cap - 1), first; \
+	if (num > rb->tailcopy - head) { \
+		rb->tailcopy = bbatomic_load(&rb->tail, BBATOMIC_ACQUIRE); \
+		if (num > rb->tailcopy - head) \
+			num = rb->tailcopy - head; \
+	} \
+	if (num == 0) \
+		return 0; \
+	first = rb->cap - pos < num ? rb->cap - pos : num; \
+	memcpy(array, &rb->at[pos], sizeof(ELEMENT) * first); \
+	memcpy(array + first, rb->at, sizeof(ELEMENT) * (num - first)); \
+	bbatomic_store(&rb->head, head + num, BBATOMIC_RELEASE); \
+	return num; \
+} \
+bbstatic_semicolon
+
+/* Single-Producer/Single-Consumer Ring automatic memory management. */
+#define SPSCRING_AUTO_IMPLEMENTATION(RB, ELEMENT, ALLOC, FREE) \
+\
+void RB##_ainit(size_t cap, struct RB *rb) \
+{	cap = bbvector_pow2(cap); \
+	RB##_init(ALLOC(cap, sizeof(ELEMENT)), cap, rb); \
+} \
+void RB##_afini(struct RB *rb) \
+{	FREE(RB##_fini(rb)); \
+} \
+bbstatic_semicolon
+
+/* Single-Producer/Single-Consumer Ring automatic memory management. */
+#define SPSCRING_IMPLEMENTATION(RB, ELEMENT, ALLOC, FREE) \
+	SPSCRING_CORE_IMPLEMENTATION(RB, ELEMENT); \
+	SPSCRING_AUTO_IMPLEMENTATION(RB, ELEMENT, ALLOC, FREE)
+
+/* Single-Producer/Single-Consumer Ring core full. */
+#define SPSCRING_CORE(RB, ELEMENT) \
+	SPSCRING_CORE_INTERFACE(RB, ELEMENT, static BBUNUSED); \
+	SPSCRING_CORE_IMPLEMENTATION(RB, ELEMENT)
+
+/* Single-Producer/Single-Consumer Ring automatic memory management full. */
+#define SPSCRING(RB, ELEMENT, ALLOC, FREE) \
+	SPSCRING_INTERFACE(RB, ELEMENT, static BBUNUSED); \
+	SPSCRING_IMPLEMENTATION(RB, ELEMENT, ALLOC, FREE)
+
+/****************************************
+ * Multi-Producer/Multi-Consumer Ring interface.
+ ****************************************/
+
+/*
+ * Multi-Producer/Multi-Consumer Ring structure.
+ * Every cell has a sequence number telling whose turn it is:
+ * it equals the position for a push, and the position plus one for a pop.
+ * A thread claims a position with a compare-and-swap on the counter
+ * and hands the cell over by updating its sequence number after the copy.
+ */
+#define MPMCRING_STRUCT(RB, ELEMENT) \
+\
+struct RB##_cell { \
+	BBATOMIC(size_t) seq; /* Sequence number. */ \
+	ELEMENT value; \
+}; \
+struct RB { \
+	size_t cap; /* Capacity (a power of two). */ \
+	struct RB##_cell *cell; /* Beginning of memory. */ \
+	char pad1[BBCACHELINE]; \
+	BBATOMIC(size_t) head; /* Position to pop. */ \
+	char pad2[BBCACHELINE]; \
+	BBATOMIC(size_t) tail; /* Position to push. */ \
+	char pad3[BBCACHELINE]; \
+}
+
+/*
+ * Multi-Producer/Multi-Consumer Ring core procedures.
+ * Any number of threads may push and pop at a time.
+ * The capacity given to `init` is a power of two, at least 2
+ * (with one cell the sequence numbers of a push and a pop coincide).
+ * The `push` and `pop` procedures return 0 on success and -1 if the ring
+ * is full (or empty). The `len` procedure returns a snapshot.
+ */
+#define MPMCRING_CORE_DECLARATIONS(RB, ELEMENT, PREFIX) \
+\
+PREFIX void RB##_init(struct RB##_cell *array, size_t cap, struct RB *rb); \
+PREFIX struct RB##_cell *RB##_fini(struct RB *rb); \
+PREFIX size_t RB##_len(struct RB *rb); \
+\
+PREFIX int RB##_push(ELEMENT value, struct RB *rb); \
+PREFIX int RB##_pop(ELEMENT *value, struct RB *rb); \
+bbstatic_semicolon
+
+/*
+ * Multi-Producer/Multi-Consumer Ring automatic memory management appendix.
+ * The capacity is rounded up to a power of two (at least 2).
+ */
+#define MPMCRING_AUTO_DECLARATIONS(RB, ELEMENT, PREFIX) \
+\
+PREFIX void RB##_ainit(size_t cap, struct RB *rb); \
+PREFIX void RB##_afini(struct RB *rb); \
+bbstatic_semicolon
+
+/* Multi-Producer/Multi-Consumer Ring automatic memory management. */
+#define MPMCRING_DECLARATIONS(RB, ELEMENT, PREFIX) \
+	MPMCRING_CORE_DECLARATIONS(RB, ELEMENT, PREFIX); \
+	MPMCRING_AUTO_DECLARATIONS(RB, ELEMENT, PREFIX)
+
+/* Multi-Producer/Multi-Consumer Ring core interface. */
+#define MPMCRING_CORE_INTERFACE(RB, ELEMENT, PREFIX) \
+	MPMCRING_STRUCT(RB, ELEMENT); \
+	MPMCRING_CORE_DECLARATIONS(RB, ELEMENT, PREFIX)
+
+/* Multi-Producer/Multi-Consumer Ring automatic memory management. */
+#define MPMCRING_INTERFACE(RB, ELEMENT, PREFIX) \
+	MPMCRING_STRUCT(RB, ELEMENT); \
+	MPMCRING_DECLARATIONS(RB, ELEMENT, PREFIX)
+
+/****************************************
+ * Multi-Producer/Multi-Consumer Ring implementation.
+ ****************************************/
+
+/* Multi-Producer/Multi-Consumer Ring core procedures. */
+#define MPMCRING_CORE_IMPLEMENTATION(RB, ELEMENT) \
+\
+void RB##_init(struct RB##_cell *array, size_t cap, struct RB *rb) \
+{	size_t num; \
+	rb->cap = cap; \
+	rb->cell = array; \
+	for (num = 0; num < cap; num++) \
+		bbatomic_store(&array[num].seq, num, BBATOMIC_RELAXED); \
+	bbatomic_store(&rb->head, 0, BBATOMIC_RELAXED); \
+	bbatomic_store(&rb->tail, 0, BBATOMIC_RELAXED); \
+} \
+struct RB##_cell *RB##_fini(struct RB *rb) \
+{	return rb->cell; \
+} \
+size_t RB##_len(struct RB *rb) \
+{	size_t head = bbatomic_load(&rb->head, BBATOMIC_ACQUIRE); \
+	size_t tail = bbatomic_load(&rb->tail, BBATOMIC_ACQUIRE); \
+	return tail - head > rb->cap ? 0 : tail - head; \
+} \
+int RB##_push(ELEMENT value, struct RB *rb) \
+{	size_t tail = bbatomic_load(&rb->tail, BBATOMIC_RELAXED); \
+	struct RB##_cell *cell; \
+	for (;;) { \
+		ptrdiff_t diff; \
+		cell = &rb->cell[tail & (rb->cap - 1)]; \
+		diff = (ptrdiff_t)(bbatomic_load(&cell->seq, BBATOMIC_ACQUIRE) - \
+			tail); \
+		if (diff == 0) { \
+			if (bbatomic_cas_weak(&rb->tail, &tail, tail + 1, \
+				BBATOMIC_RELAXED)) \
+				break; \
+		} else if (diff < 0) { \
+			return -1; \
+		} else { \
+			tail = bbatomic_load(&rb->tail, BBATOMIC_RELAXED); \
+		} \
+	} \
+	cell->value = value; \
+	bbatomic_store(&cell->seq, tail + 1, BBATOMIC_RELEASE); \
+	return 0; \
+} \
+int RB##_pop(ELEMENT *value, struct RB *rb) \
+{	size_t head = bbatomic_load(&rb->head, BBATOMIC_RELAXED); \
+	struct RB##_cell *cell; \
+	for (;;) { \
+		ptrdiff_t diff; \
+		cell = &rb->cell[head & (rb->cap - 1)]; \
+		diff = (ptrdiff_t)(bbatomic_load(&cell->seq, BBATOMIC_ACQUIRE) - \
+			(head + 1)); \
+		if (diff == 0) { \
+			if (bbatomic_cas_weak(&rb->head, &head, head + 1, \
+				BBATOMIC_RELAXED)) \
+				break; \
+		} else if (diff < 0) { \
+			return -1; \
+		} else { \
+			head = bbatomic_load(&rb->head, BBATOMIC_RELAXED); \
+		} \
+	} \
+	*value = cell->value; \
+	bbatomic_store(&cell->seq, head + rb->cap, BBATOMIC_RELEASE); \
+	return 0; \
+} \
+bbstatic_semicolon
+
+/* Multi-Producer/Multi-Consumer Ring automatic memory management. */
+#define MPMCRING_AUTO_IMPLEMENTATION(RB, ELEMENT, ALLOC, FREE) \
+\
+void RB##_ainit(size_t cap, struct RB *rb) \
+{	if (cap < 2) \
+		cap = 2; \
+	cap = bbvector_pow2(cap); \
+	RB##_init(ALLOC(cap, sizeof(struct RB##_cell)), cap, rb); \
+} \
+void RB##_afini(struct RB *rb) \
+{	FREE(RB##_fini(rb)); \
+} \
+bbstatic_semicolon
+
+/* Multi-Producer/Multi-Consumer Ring automatic memory management. */
+#define MPMCRING_IMPLEMENTATION(RB, ELEMENT, ALLOC, FREE) \
+	MPMCRING_CORE_IMPLEMENTATION(RB, ELEMENT); \
+	MPMCRING_AUTO_IMPLEMENTATION(RB, ELEMENT, ALLOC, FREE)
+
+/* Multi-Producer/Multi-Consumer Ring core full. */
+#define MPMCRING_CORE(RB, ELEMENT) \
+	MPMCRING_CORE_INTERFACE(RB, ELEMENT, static BBUNUSED); \
+	MPMCRING_CORE_IMPLEMENTATION(RB, ELEMENT)
+
+/* Multi-Producer/Multi-Consumer Ring automatic memory management full. */
+#define MPMCRING(RB, ELEMENT, ALLOC, FREE) \
+	MPMCRING_INTERFACE(RB, ELEMENT, static BBUNUSED); \
+	MPMCRING_IMPLEMENTATION(RB, ELEMENT, ALLOC, FREE)
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef BBMACRO_SOA_H_
+#define BBMACRO_SOA_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <string.h>
+#include <bbmacro/static.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * Structure of Arrays: a backward vector of rows stored column by column.
+ * 1. The fields are given by a list macro taking a macro argument
+ *    (C89 has no variadic macros):
+ *    #define MYROW(FIELD) FIELD(float, x) FIELD(float, y) FIELD(int, id)
+ *    Every field gets its own contiguous column, so a loop over one field
+ *    touches only that field (and can be vectorized).
+ * 2. All the columns share the length and the capacity, and live in one
+ *    block of memory, so the growth reallocates and copies all the columns
+ *    at once. Every column starts at a multiple of BBSOA_ALIGN bytes from
+ *    the beginning of the block; the columns are aligned to BBSOA_ALIGN
+ *    only if the block is (as with SOA_DEFAULT).
+ * 3. Core procedures provide manual memory management only
+ *    (the block must hold `memlen(cap)` bytes).
+ * 4. Structure members are a read-only part of the interface.
+ * 5. Note the vector itself is always the last argument of a procedure.
+ */
+
+/*
+ * How to use the vector?
+ * SOA_DEFAULT(mysoa, MYROW);
+ * struct mysoa v;
+ * struct mysoa_row row;
+ * size_t num;
+ * mysoa_ainit(0, &v);
+ * row.x = 1; row.y = 2; row.id = 3;
+ * mysoa_apushback(row, &v);
+ * for (num = 0; num < v.len; num++)
+ *     sum += v.x[num];
+ * mysoa_afini(&v);
+ */
+
+/* Alignment of a column in bytes. */
+#define BBSOA_ALIGN 64
+
+/*
+ * Add the length of a column (rounded up to the alignment) to the length
+ * of a block. The result is saturated to `(size_t)-1` on overflow,
+ * so an allocation fails.
+ */
+static BBUNUSED size_t bbsoa_column(size_t len, size_t cap, size_t size)
+{
+	size_t col;
+
+	if (cap > ((size_t)-1 - BBSOA_ALIGN) / size)
+		return (size_t)-1;
+	col = (cap * size + BBSOA_ALIGN - 1) & ~(size_t)(BBSOA_ALIGN - 1);
+	if (len > (size_t)-1 - col)
+		return (size_t)-1;
+	return len + col;
+}
+
+/* Field macros applied to the list of fields. */
+#define BBSOA_ROW(TYPE, NAME) TYPE NAME;
+#define BBSOA_MEMBER(TYPE, NAME) TYPE *NAME;
+#define BBSOA_MEMLEN(TYPE, NAME) len = bbsoa_column(len, cap, sizeof(TYPE));
+#define BBSOA_PLACE(TYPE, NAME) \
+	sa->NAME = (TYPE *)(void *)(block + len); \
+	len = bbsoa_column(len, cap, sizeof(TYPE));
+#define BBSOA_COPY(TYPE, NAME) \
+	memcpy(sa->NAME, old.NAME, sizeof(TYPE) * sa->len);
+#define BBSOA_GET(TYPE, NAME) row.NAME = sa->NAME[num];
+#define BBSOA_SET(TYPE, NAME) sa->NAME[num] = row.NAME;
+
+/****************************************
+ * Structure of Arrays interface.
+ ****************************************/
+
+/* Structure of Arrays structure (and the structure of a row). */
+#define SOA_STRUCT(SA, FIELDS) \
+\
+struct SA##_row { \
+	FIELDS(BBSOA_ROW) \
+}; \
+struct SA { \
+	size_t len, cap; /* Length and capacity. */ \
+	void *block; /* Beginning of memory. */ \
+	FIELDS(BBSOA_MEMBER) /* Columns. */ \
+}
+
+/*
+ * Structure of Arrays core procedures.
+ * The `growback` procedure returns the index of the first new row.
+ */
+#define SOA_CORE_DECLARATIONS(SA, FIELDS, PREFIX) \
+\
+PREFIX size_t SA##_memlen(size_t cap); \
+PREFIX void SA##_init(void *block, size_t cap, struct SA *sa); \
+PREFIX void *SA##_fini(struct SA *sa); \
+PREFIX void SA##_clear(struct SA *sa); \
+PREFIX int SA##_full(struct SA *sa); \
+\
+PREFIX void *SA##_reserveback(void *block, size_t cap, struct SA *sa); \
+PREFIX void SA##_pushback(struct SA##_row row, struct SA *sa); \
+PREFIX size_t SA##_growback(size_t num, struct SA *sa); \
+PREFIX void SA##_popback(struct SA *sa); \
+PREFIX void SA##_cutback(size_t num, struct SA *sa); \
+PREFIX void SA##_resizeback(size_t len, struct SA *sa); \
+\
+PREFIX struct SA##_row SA##_get(size_t num, struct SA *sa); \
+PREFIX void SA##_set(size_t num, struct SA##_row row, struct SA *sa); \
+bbstatic_semicolon
+
+/* Structure of Arrays automatic memory management appendix. */
+#define SOA_AUTO_DECLARATIONS(SA, FIELDS, PREFIX) \
+\
+PREFIX void SA##_ainit(size_t cap, struct SA *sa); \
+PREFIX void SA##_afini(struct SA *sa); \
+PREFIX void SA##_aclear(struct SA *sa); \
+\
+PREFIX void SA##_areserveback(size_t cap, struct SA *sa); \
+PREFIX void SA##_apushback(struct SA##_row row, struct SA *sa); \
+PREFIX size_t SA##_agrowback(size_t num, struct SA *sa); \
+PREFIX void SA##_aresizeback(size_t len, struct SA *sa); \
+PREFIX void SA##_ashrink(struct SA *sa); \
+bbstatic_semicolon
+
+/* Structure of Arrays automatic memory management procedures. */
+#define SOA_DECLARATIONS(SA, FIELDS, PREFIX) \
+	SOA_CORE_DECLARATIONS(SA, FIELDS, PREFIX); \
+	SOA_AUTO_DECLARATIONS(SA, FIELDS, PREFIX)
+
+/* Structure of Arrays core interface. */
+#define SOA_CORE_INTERFACE(SA, FIELDS, PREFIX) \
+	SOA_STRUCT(SA, FIELDS); \
+	SOA_CORE_DECLARATIONS(SA, FIELDS, PREFIX)
+
+/* Structure of Arrays automatic memory management interface. */
+#define SOA_INTERFACE(SA, FIELDS, PREFIX) \
+	SOA_STRUCT(SA, FIELDS); \
+	SOA_DECLARATIONS(SA, FIELDS, PREFIX)
+
+/****************************************
+ * Structure of Arrays implementation.
+ ****************************************/
+
+/* Structure of Arrays core procedures. */
+#define SOA_CORE_IMPLEMENTATION(SA, FIELDS) \
+\
+static BBUNUSED void SA##_place_(char *block, size_t cap, struct SA *sa) \
+{	size_t len = 0; \
+	sa->block = block; \
+	sa->cap = cap; \
+	FIELDS(BBSOA_PLACE) \
+} \
+size_t SA##_memlen(size_t cap) \
+{	size_t len = 0; \
+	FIELDS(BBSOA_MEMLEN) \
+	return len; \
+} \
+void SA##_init(void *block, size_t cap, struct SA *sa) \
+{	SA##_place_(block, cap, sa); \
+	sa->len = 0; \
+} \
+void *SA##_fini(struct SA *sa) \
+{	return sa->block; \
+} \
+void SA##_clear(struct SA *sa) \
+{	sa->len = 0; \
+} \
+int SA##_full(struct SA *sa) \
+{	return sa->len == sa->cap; \
+} \
+void *SA##_reserveback(void *block, size_t cap, struct SA *sa) \
+{	struct SA old = *sa; \
+	SA##_place_(block, cap, sa); \
+	if (sa->len) { \
+		FIELDS(BBSOA_COPY) \
+	} \
+	return old.block; \
+} \
+void SA##_pushback(struct SA##_row row, struct SA *sa) \
+{	size_t num = sa->len++; \
+	FIELDS(BBSOA_SET) \
+} \
+size_t SA##_growback(size_t num, struct SA *sa) \
+{	size_t old = sa->len; \
+	sa->len += num; \
+	return old; \
+} \
+void SA##_popback(struct SA *sa) \
+{	sa->len--; \
+} \
+void SA##_cutback(size_t num, struct SA *sa) \
+{	sa->len -= num; \
+} \
+void SA##_resizeback(size_t len, struct SA *sa) \
+{	sa->len = len; \
+} \
+struct SA##_row SA##_get(size_t num, struct SA *sa) \
+{	struct SA##_row row; \
+	FIELDS(BBSOA_GET) \
+	return row; \
+} \
+void SA##_set(size_t num, struct SA##_row row, struct SA *sa) \
+{	FIELDS(BBSOA_SET) \
+} \
+bbstatic_semicolon
+
+/*
+ * Structure of Arrays automatic memory management appendix.
+ * The arguments are the same as for BVECTOR_AUTO_IMPLEMENTATION;
+ * the block is allocated in bytes (`ALLOC(memlen(cap), 1)`).
+ * ALLOC must return blocks aligned to BBSOA_ALIGN for aligned columns.
+ */
+#define SOA_AUTO_IMPLEMENTATION(SA, FIELDS, ALLOC, FREE, NEXT_CAP) \
+\
+void SA##_ainit(size_t cap, struct SA *sa) \
+{	SA##_init(ALLOC(SA##_memlen(cap), 1), cap, sa); \
+} \
+void SA##_afini(struct SA *sa) \
+{	FREE(SA##_fini(sa)); \
+} \
+void SA##_aclear(struct SA *sa) \
+{	FREE(sa->block); \
+	SA##_init(NULL, 0, sa); \
+} \
+void SA##_areserveback(size_t cap, struct SA *sa) \
+{	FREE(SA##_reserveback(ALLOC(SA##_memlen(cap), 1), cap, sa)); \
+} \
+void SA##_apushback(struct SA##_row row, struct SA *sa) \
+{	if (SA##_full(sa)) \
+		SA##_areserveback(NEXT_CAP(sa->cap), sa); \
+	SA##_pushback(row, sa); \
+} \
+size_t SA##_agrowback(size_t num, struct SA *sa) \
+{	size_t len = sa->len + num; \
+	size_t cap = sa->cap; \
+	if (len > cap) { \
+		cap = NEXT_CAP(cap); \
+		if (len > cap) \
+			cap = len; \
+		SA##_areserveback(cap, sa); \
+	} \
+	return SA##_growback(num, sa); \
+} \
+void SA##_aresizeback(size_t len, struct SA *sa) \
+{	size_t cap = sa->cap; \
+	if (len > cap) { \
+		cap = NEXT_CAP(cap); \
+		if (len > cap) \
+			cap = len; \
+		SA##_areserveback(cap, sa); \
+	} \
+	sa->len = len; \
+} \
+void SA##_ashrink(struct SA *sa) \
+{	if (sa->len < sa->cap) \
+		SA##_areserveback(sa->len, sa); \
+} \
+bbstatic_semicolon
+
+/* Structure of Arrays automatic memory management procedures. */
+#define SOA_IMPLEMENTATION(SA, FIELDS, ALLOC, FREE, NEXT_CAP) \
+	SOA_CORE_IMPLEMENTATION(SA, FIELDS); \
+	SOA_AUTO_IMPLEMENTATION(SA, FIELDS, ALLOC, FREE, NEXT_CAP)
+
+/* Structure of Arrays core full. */
+#define SOA_CORE(SA, FIELDS) \
+	SOA_CORE_INTERFACE(SA, FIELDS, static BBUNUSED); \
+	SOA_CORE_IMPLEMENTATION(SA, FIELDS)
+
+/* Structure of Arrays automatic memory management full. */
+#define SOA(SA, FIELDS, ALLOC, FREE, NEXT_CAP) \
+	SOA_INTERFACE(SA, FIELDS, static BBUNUSED); \
+	SOA_IMPLEMENTATION(SA, FIELDS, ALLOC, FREE, NEXT_CAP)
+
+#endif
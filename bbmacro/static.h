@@ -23,6 +23,21 @@
 #  define BBINLINE
 #endif
 
+/* Storage class of a variable with a separate instance in every thread. */
+#if __STDC_VERSION__ >= 201112L /* C11. */
+#  define BBTHREADLOCAL _Thread_local
+#elif defined(__GNUC__)
+#  define BBTHREADLOCAL __thread
+#else
+#  define BBTHREADLOCAL
+#endif
+
+/* Defined if SSE2 instructions are available (unless BBNOSIMD is defined). */
+#if !defined(BBNOSIMD) && (defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define BBSSE2
+#endif
+
 /* Attribute for suppressing warning about something unused. */
 #if defined(__GNUC__)
 #  define BBUNUSED __attribute__((unused))
@@ -0,0 +1,198 @@
+#ifndef BBMACRO_STRBUF_H_
+#define BBMACRO_STRBUF_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/hashmap.h>
+#include <bbmacro/pqueue.h>
+#include <bbmacro/soa.h>
+#ifdef BBMEMORY_STATS
+#include <bbmacro/ansicolor.h>
+#endif
+#ifdef BBMEMORY_MMAP
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include <bbmacro/memory.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * String builder: a Backward Vector of characters (`BVECTOR_DEFAULT`),
+ * so every procedure of it may be used as well (`bbstrbuf_ainit`,
+ * `bbstrbuf_afini`, `bbstrbuf_clear`, ...).
+ * 1. The appends grow the memory like the vector does, so a string is
+ *    built with amortized constant time appends and no temporary buffers.
+ * 2. The string is not terminated until `cstr` (or `steal`) is called.
+ * 3. The formatted append requires `vsnprintf()` (C99 or POSIX),
+ *    see BBSTRBUF_FORMAT.
+ * 4. Note the builder itself is the last argument of a procedure,
+ *    except for the formatted append.
+ */
+
+/*
+ * How to use the builder?
+ * struct bbstrbuf sb;
+ * bbstrbuf_ainit(256, &sb);
+ * bbstrbuf_appends("request ", &sb);
+ * bbstrbuf_appendul(id, &sb);
+ * bbstrbuf_appendf(&sb, " took %.3f ms\n", ms);
+ * fwrite(sb.at, 1, sb.len, log);
+ * bbstrbuf_clear(&sb);
+ * ...
+ * bbstrbuf_afini(&sb);
+ */
+
+#if __STDC_VERSION__ >= 199901L || \
+	(defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L) || \
+	(defined(_XOPEN_SOURCE) && _XOPEN_SOURCE >= 500)
+#  define BBSTRBUF_FORMAT
+#endif
+
+BVECTOR_DEFAULT(bbstrbuf, char);
+
+/*
+ * Make room for `len` more characters.
+ */
+static BBUNUSED void bbstrbuf_reserve(size_t len, struct bbstrbuf *sb)
+{
+	if (sb->cap - sb->len < len) {
+		bbstrbuf_agrowback(len, sb);
+		bbstrbuf_cutback(len, sb);
+	}
+}
+
+/*
+ * Append characters.
+ */
+static BBUNUSED void bbstrbuf_append(const char *str, size_t len,
+	struct bbstrbuf *sb)
+{
+	bbstrbuf_aappendback(str, len, sb);
+}
+
+/*
+ * Append a string.
+ */
+static BBUNUSED void bbstrbuf_appends(const char *str, struct bbstrbuf *sb)
+{
+	bbstrbuf_aappendback(str, strlen(str), sb);
+}
+
+/*
+ * Append a character.
+ */
+static BBUNUSED void bbstrbuf_appendc(char chr, struct bbstrbuf *sb)
+{
+	bbstrbuf_apushback(chr, sb);
+}
+
+/*
+ * Append an unsigned integer in decimal (two digits at a time).
+ */
+static BBUNUSED void bbstrbuf_appendul(unsigned long num,
+	struct bbstrbuf *sb)
+{
+	static const char digits[] =
+		"00010203040506070809" "10111213141516171819"
+		"20212223242526272829" "30313233343536373839"
+		"40414243444546474849" "50515253545556575859"
+		"60616263646566676869" "70717273747576777879"
+		"80818283848586878889" "90919293949596979899";
+	char buf[sizeof(unsigned long) * 3];
+	char *ptr = buf + sizeof(buf);
+
+	while (num >= 100) {
+		const char *pair = &digits[num % 100 * 2];
+		num /= 100;
+		*--ptr = pair[1];
+		*--ptr = pair[0];
+	}
+	if (num >= 10) {
+		*--ptr = digits[num * 2 + 1];
+		*--ptr = digits[num * 2];
+	} else {
+		*--ptr = (char)('0' + num);
+	}
+	bbstrbuf_aappendback(ptr, (size_t)(buf + sizeof(buf) - ptr), sb);
+}
+
+/*
+ * Append a signed integer in decimal.
+ */
+static BBUNUSED void bbstrbuf_appendl(long num, struct bbstrbuf *sb)
+{
+	if (num < 0) {
+		bbstrbuf_apushback('-', sb);
+		bbstrbuf_appendul(0UL - (unsigned long)num, sb);
+	} else {
+		bbstrbuf_appendul((unsigned long)num, sb);
+	}
+}
+
+#ifdef BBSTRBUF_FORMAT
+
+/*
+ * Append a formatted string (like `sprintf()`).
+ * Return 0 on success, -1 on an encoding error.
+ */
+static BBUNUSED int bbstrbuf_appendf(struct bbstrbuf *sb,
+	const char *format, ...)
+{
+	size_t room = sb->cap - sb->len;
+	va_list args;
+	int len;
+
+	va_start(args, format);
+	len = vsnprintf(sb->at + sb->len, room, format, args);
+	va_end(args);
+	if (len < 0)
+		return -1;
+	if ((size_t)len >= room) { /* Not enough room: format again. */
+		bbstrbuf_reserve((size_t)len + 1, sb);
+		va_start(args, format);
+		len = vsnprintf(sb->at + sb->len, (size_t)len + 1, format, args);
+		va_end(args);
+		if (len < 0)
+			return -1;
+	}
+	sb->len += (size_t)len;
+	return 0;
+}
+
+#endif
+
+/*
+ * Terminate the string with the null character (not counted in the
+ * length) and return it. The string is valid until the next append.
+ */
+static BBUNUSED char *bbstrbuf_cstr(struct bbstrbuf *sb)
+{
+	bbstrbuf_apushback('\0', sb);
+	bbstrbuf_popback(sb);
+	return sb->at;
+}
+
+/*
+ * Take the terminated string away (free it with `free()`);
+ * the builder is left empty.
+ */
+static BBUNUSED char *bbstrbuf_steal(struct bbstrbuf *sb)
+{
+	char *str = bbstrbuf_cstr(sb);
+
+	bbstrbuf_init(NULL, 0, sb);
+	return str;
+}
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef BBMACRO_STREAM_H_
+#define BBMACRO_STREAM_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <errno.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <bbmacro/static.h>
+#include <bbmacro/vector.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * Streaming appendix to the vectors (POSIX): sending the elements
+ * through pipes and sockets.
+ * 1. A vector is sent as frames: a count of elements (4 bytes, the least
+ *    significant first) followed by the raw elements. A frame holds about
+ *    BBSTREAM_CHUNK bytes; the zero count ends the vector.
+ * 2. The writer sends up to BBSTREAM_BATCH frames with one `writev()`
+ *    straight from the vector: nothing is copied or allocated.
+ *    The descriptor must be blocking: a partial write is finished in the
+ *    same call, and EAGAIN fails it with the stream cut at an unknown byte.
+ * 3. The reader decodes the bytes as they come (`sfeed`), in pieces of
+ *    any size, growing the vector with `agrowback` once per frame;
+ *    a blocking reader (`sread`) reads the frames straight into the
+ *    vector and never reads past the end of it.
+ * 4. The elements must be plain data (no pointers) of the same layout
+ *    for the writer and for the reader.
+ */
+
+/*
+ * How to use the procedures?
+ * BVECTOR_DEFAULT(samples, double);
+ * BVECTOR_STREAM(samples, double);
+ * ... a writer ...
+ * if (samples_swrite(sock, &v)) ... error ...
+ * ... a reader with an event loop ...
+ * struct bbstream st;
+ * bbstream_init(&st);
+ * ... on every piece of data ...
+ * switch (samples_sfeed(buf, len, &st, &v)) ... -1, 0 or 1 ...
+ */
+
+/* Size of the elements of a frame (approximately). */
+#define BBSTREAM_CHUNK 65536
+
+/* Maximum number of buffers of one `writev()` (at least 16 in POSIX). */
+#ifdef IOV_MAX
+#  define BBSTREAM_IOV IOV_MAX
+#else
+#  define BBSTREAM_IOV 16
+#endif
+
+/* Number of frames in a batch written at once (two buffers per frame). */
+#define BBSTREAM_BATCH (BBSTREAM_IOV > 32 ? 16 : (BBSTREAM_IOV - 1) / 2)
+
+/* Maximum size of the elements of a frame accepted by a reader. */
+#define BBSTREAM_MAXFRAME ((size_t)16 << 20)
+
+/* Decoder state. */
+struct bbstream {
+	unsigned char head[4]; /* Count of the current frame. */
+	size_t headlen; /* Bytes of the count received. */
+	size_t left; /* Bytes of the current frame not received yet. */
+	size_t part; /* Bytes of the incomplete element received. */
+	size_t used; /* Bytes used by the last `sfeed` call. */
+	int done; /* The end frame has been received. */
+};
+
+/*
+ * Start decoding a vector.
+ */
+static BBUNUSED void bbstream_init(struct bbstream *st)
+{
+	st->headlen = 0;
+	st->left = 0;
+	st->part = 0;
+	st->used = 0;
+	st->done = 0;
+}
+
+/* Store and load a frame count. */
+static BBUNUSED void bbstream_put(unsigned char *at, unsigned long num)
+{
+	at[0] = (unsigned char)(num & 0xFF);
+	at[1] = (unsigned char)(num >> 8 & 0xFF);
+	at[2] = (unsigned char)(num >> 16 & 0xFF);
+	at[3] = (unsigned char)(num >> 24 & 0xFF);
+}
+
+static BBUNUSED unsigned long bbstream_get(const unsigned char *at)
+{
+	return (unsigned long)at[0] | (unsigned long)at[1] << 8 |
+		(unsigned long)at[2] << 16 | (unsigned long)at[3] << 24;
+}
+
+/*
+ * Write all the buffers (the array is modified) to a blocking descriptor.
+ * Return 0 on success, -1 on failure.
+ */
+static BBUNUSED int bbstream_writev(int fd, struct iovec *iov, int cnt)
+{
+	while (cnt > 0) {
+		ssize_t res = writev(fd, iov, cnt);
+		size_t done;
+		if (res < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		for (done = (size_t)res; cnt > 0 && done >= iov->iov_len; cnt--)
+			done -= iov++->iov_len;
+		if (cnt > 0) {
+			iov->iov_base = (char *)iov->iov_base + done;
+			iov->iov_len -= done;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Read exactly `len` bytes. Return 0 on success, -1 on failure
+ * (including the end of file).
+ */
+static BBUNUSED int bbstream_readall(int fd, void *buf, size_t len)
+{
+	char *ptr = buf;
+
+	while (len > 0) {
+		ssize_t res = read(fd, ptr, len);
+		if (res < 0 && errno == EINTR)
+			continue;
+		if (res <= 0)
+			return -1;
+		ptr += res;
+		len -= (size_t)res;
+	}
+	return 0;
+}
+
+/*
+ * Write the elements as frames ending with the zero count.
+ * Return 0 on success, -1 on failure.
+ */
+static BBUNUSED int bbstream_write(int fd, const void *at, size_t len,
+	size_t size)
+{
+	unsigned char head[BBSTREAM_BATCH + 1][4];
+	struct iovec iov[BBSTREAM_BATCH * 2 + 1];
+	size_t frame = BBSTREAM_CHUNK / size ? BBSTREAM_CHUNK / size : 1;
+	const char *ptr = at;
+	int end = 0;
+
+	while (!end) {
+		int cnt = 0, num;
+		for (num = 0; num < BBSTREAM_BATCH && len > 0; num++) {
+			size_t cur = len < frame ? len : frame;
+			bbstream_put(head[num], (unsigned long)cur);
+			iov[cnt].iov_base = head[num];
+			iov[cnt++].iov_len = 4;
+			iov[cnt].iov_base = (void *)ptr;
+			iov[cnt++].iov_len = cur * size;
+			ptr += cur * size;
+			len -= cur;
+		}
+		if (len == 0) {
+			bbstream_put(head[num], 0);
+			iov[cnt].iov_base = head[num];
+			iov[cnt++].iov_len = 4;
+			end = 1;
+		}
+		if (bbstream_writev(fd, iov, cnt))
+			return -1;
+	}
+	return 0;
+}
+
+/****************************************
+ * Streaming interface.
+ ****************************************/
+
+/*
+ * Backward Vector streaming procedures.
+ * The `swrite` and `sread` procedures return 0 on success and -1 on
+ * failure (the complete frames read are appended to the vector).
+ * The `sfeed` procedure appends the elements decoded from the bytes
+ * and returns 1 if the vector is complete (then `st->used` bytes have
+ * been used, the rest belongs to what follows), 0 if more bytes are
+ * expected, -1 if the bytes are not a valid stream.
+ */
+#define BVECTOR_STREAM_DECLARATIONS(BV, ELEMENT, PREFIX) \
+\
+PREFIX int BV##_swrite(int fd, struct BV *bv); \
+PREFIX int BV##_sread(int fd, struct BV *bv); \
+PREFIX int BV##_sfeed(const void *data, size_t len, struct bbstream *st, \
+	struct BV *bv); \
+bbstatic_semicolon
+
+/* Forward Vector streaming procedures (the front element goes first). */
+#define FVECTOR_STREAM_DECLARATIONS(FV, ELEMENT, PREFIX) \
+\
+PREFIX int FV##_swrite(int fd, struct FV *fv); \
+bbstatic_semicolon
+
+/****************************************
+ * Streaming implementation.
+ ****************************************/
+
+/* Backward Vector streaming procedures. */
+#define BVECTOR_STREAM_IMPLEMENTATION(BV, ELEMENT) \
+\
+int BV##_swrite(int fd, struct BV *bv) \
+{	return bbstream_write(fd, bv->at, bv->len, sizeof(ELEMENT)); \
+} \
+int BV##_sread(int fd, struct BV *bv) \
+{	unsigned char head[4]; \
+	size_t num; \
+	for (;;) { \
+		if (bbstream_readall(fd, head, 4)) \
+			return -1; \
+		num = bbstream_get(head); \
+		if (num == 0) \
+			return 0; \
+		if (num > BBSTREAM_MAXFRAME / sizeof(ELEMENT)) \
+			return -1; \
+		if (bbstream_readall(fd, BV##_agrowback(num, bv), \
+			num * sizeof(ELEMENT))) { \
+			BV##_cutback(num, bv); \
+			return -1; \
+		} \
+	} \
+} \
+int BV##_sfeed(const void *data, size_t len, struct bbstream *st, \
+	struct BV *bv) \
+{	const unsigned char *ptr = data, *end = ptr + len; \
+	st->used = 0; \
+	if (st->done) \
+		return 1; \
+	while (ptr != end) { \
+		size_t cur; \
+		if (st->left == 0) { /* A count. */ \
+			size_t num; \
+			st->head[st->headlen++] = *ptr++; \
+			if (st->headlen < 4) \
+				continue; \
+			st->headlen = 0; \
+			num = bbstream_get(st->head); \
+			if (num == 0) { \
+				st->done = 1; \
+				break; \
+			} \
+			if (num > BBSTREAM_MAXFRAME / sizeof(ELEMENT)) \
+				return -1; \
+			/* Reserve the frame; the length grows by elements. */ \
+			BV##_agrowback(num, bv); \
+			BV##_cutback(num, bv); \
+			st->left = num * sizeof(ELEMENT); \
+			continue; \
+		} \
+		cur = (size_t)(end - ptr) < st->left ? \
+			(size_t)(end - ptr) : st->left; \
+		memcpy((char *)&bv->at[bv->len] + st->part, ptr, cur); \
+		ptr += cur; \
+		st->left -= cur; \
+		st->part += cur; \
+		bv->len += st->part / sizeof(ELEMENT); \
+		st->part %= sizeof(ELEMENT); \
+	} \
+	st->used = (size_t)(ptr - (const unsigned char *)data); \
+	return st->done; \
+} \
+bbstatic_semicolon
+
+/* Forward Vector streaming procedures. */
+#define FVECTOR_STREAM_IMPLEMENTATION(FV, ELEMENT) \
+\
+int FV##_swrite(int fd, struct FV *fv) \
+{	return bbstream_write(fd, fv->neg - fv->len, fv->len, \
+		sizeof(ELEMENT)); \
+} \
+bbstatic_semicolon
+
+/* Backward Vector streaming full. */
+#define BVECTOR_STREAM(BV, ELEMENT) \
+	BVECTOR_STREAM_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	BVECTOR_STREAM_IMPLEMENTATION(BV, ELEMENT)
+
+/* Forward Vector streaming full. */
+#define FVECTOR_STREAM(FV, ELEMENT) \
+	FVECTOR_STREAM_DECLARATIONS(FV, ELEMENT, static BBUNUSED); \
+	FVECTOR_STREAM_IMPLEMENTATION(FV, ELEMENT)
+
+#endif
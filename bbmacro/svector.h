@@ -0,0 +1,172 @@
+#ifndef BBMACRO_SVECTOR_H_
+#define BBMACRO_SVECTOR_H_
+
+#ifndef NOINCLUDE
+#define NOINCLUDE
+#include <bbmacro/static.h>
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__) /* C11. */
+#include <stdatomic.h>
+#endif
+#include <bbmacro/atomic.h>
+#undef NOINCLUDE
+#endif
+
+/*
+ * Segmented Vector: a concurrent append-only vector.
+ * 1. The elements live in buckets of growing power-of-two sizes:
+ *    the bucket `k` holds BBSVECTOR_FIRST << k elements. A bucket is never
+ *    moved or freed until the vector is finished, so element addresses
+ *    are stable and no reader is ever locked out.
+ * 2. Any number of threads may push at a time: the index is taken with
+ *    a single atomic addition, and a missing bucket is installed with
+ *    a compare-and-swap (the loser frees its copy).
+ * 3. Any number of threads may read an element at a time, as long as the
+ *    push of the element has completed (e.g. the index has been passed on
+ *    after the push). The length counts the pushes started, not completed.
+ * 4. There is no core part: the vector always allocates its buckets.
+ * 5. Note the vector itself is always the last argument of a procedure.
+ */
+
+/*
+ * How to use the vector?
+ * SVECTOR_DEFAULT(myvector, struct item);
+ * struct myvector v;
+ * size_t num;
+ * myvector_ainit(0, &v);
+ * ... any thread ...
+ * num = myvector_apushback(item, &v);
+ * ... any thread, after the push of `num` ...
+ * myvector_at(num, &v)->...
+ * ... after all threads are done ...
+ * myvector_afini(&v);
+ */
+
+/* Size of the first bucket. */
+#define BBSVECTOR_SHIFT 4
+#define BBSVECTOR_FIRST ((size_t)1 << BBSVECTOR_SHIFT)
+
+/* Number of buckets enough for any index. */
+#define BBSVECTOR_BUCKETS (sizeof(size_t) * 8 - BBSVECTOR_SHIFT)
+
+/*
+ * Find the bucket of an element and the position in the bucket.
+ */
+static BBUNUSED size_t bbsvector_bucket(size_t num, size_t *pos)
+{
+	size_t bucket = 0;
+
+	num += BBSVECTOR_FIRST;
+#if defined(__GNUC__) && !defined(_WIN64)
+	bucket = sizeof(unsigned long) * 8 - 1 -
+		__builtin_clzl((unsigned long)num);
+#else
+	while (num >> bucket >> 1)
+		bucket++;
+#endif
+	*pos = num - ((size_t)1 << bucket);
+	return bucket - BBSVECTOR_SHIFT;
+}
+
+/****************************************
+ * Segmented Vector interface.
+ ****************************************/
+
+/* Segmented Vector structure. */
+#define SVECTOR_STRUCT(SV, ELEMENT) \
+\
+struct SV { \
+	BBATOMIC(size_t) len; /* Number of elements (pushes started). */ \
+	char pad[BBCACHELINE]; \
+	BBATOMIC(ELEMENT *) bucket[BBSVECTOR_BUCKETS]; /* Buckets or NULL. */ \
+}
+
+/*
+ * Segmented Vector procedures.
+ * The `apushback` procedure returns the index of the element,
+ * the `agrowback` procedure returns the index of the first of `num` ones.
+ * The `areserveback` procedure allocates the buckets in advance.
+ */
+#define SVECTOR_DECLARATIONS(SV, ELEMENT, PREFIX) \
+\
+PREFIX void SV##_ainit(size_t cap, struct SV *sv); \
+PREFIX void SV##_afini(struct SV *sv); \
+PREFIX size_t SV##_len(struct SV *sv); \
+PREFIX ELEMENT *SV##_at(size_t num, struct SV *sv); \
+\
+PREFIX void SV##_areserveback(size_t cap, struct SV *sv); \
+PREFIX size_t SV##_apushback(ELEMENT value, struct SV *sv); \
+PREFIX size_t SV##_agrowback(size_t num, struct SV *sv); \
+bbstatic_semicolon
+
+/* Segmented Vector interface. */
+#define SVECTOR_INTERFACE(SV, ELEMENT, PREFIX) \
+	SVECTOR_STRUCT(SV, ELEMENT); \
+	SVECTOR_DECLARATIONS(SV, ELEMENT, PREFIX)
+
+/****************************************
+ * Segmented Vector implementation.
+ ****************************************/
+
+/* Segmented Vector procedures. */
+#define SVECTOR_IMPLEMENTATION(SV, ELEMENT, ALLOC, FREE) \
+\
+static BBUNUSED ELEMENT *SV##_install_(size_t bucket, struct SV *sv) \
+{	ELEMENT *ptr = bbatomic_load(&sv->bucket[bucket], BBATOMIC_ACQUIRE); \
+	ELEMENT *expected = NULL; \
+	if (ptr) \
+		return ptr; \
+	ptr = ALLOC(BBSVECTOR_FIRST << bucket, sizeof(ELEMENT)); \
+	if (bbatomic_cas(&sv->bucket[bucket], &expected, ptr, \
+		BBATOMIC_ACQ_REL)) \
+		return ptr; \
+	FREE(ptr); \
+	return expected; \
+} \
+void SV##_ainit(size_t cap, struct SV *sv) \
+{	size_t bucket; \
+	bbatomic_store(&sv->len, 0, BBATOMIC_RELAXED); \
+	for (bucket = 0; bucket < BBSVECTOR_BUCKETS; bucket++) \
+		bbatomic_store(&sv->bucket[bucket], NULL, BBATOMIC_RELAXED); \
+	SV##_areserveback(cap, sv); \
+} \
+void SV##_afini(struct SV *sv) \
+{	size_t bucket; \
+	for (bucket = 0; bucket < BBSVECTOR_BUCKETS; bucket++) \
+		FREE(bbatomic_load(&sv->bucket[bucket], BBATOMIC_RELAXED)); \
+} \
+size_t SV##_len(struct SV *sv) \
+{	return bbatomic_load(&sv->len, BBATOMIC_RELAXED); \
+} \
+ELEMENT *SV##_at(size_t num, struct SV *sv) \
+{	size_t pos, bucket = bbsvector_bucket(num, &pos); \
+	return &bbatomic_load(&sv->bucket[bucket], BBATOMIC_ACQUIRE)[pos]; \
+} \
+void SV##_areserveback(size_t cap, struct SV *sv) \
+{	size_t pos, bucket; \
+	if (cap == 0) \
+		return; \
+	bucket = bbsvector_bucket(cap - 1, &pos); \
+	do \
+		SV##_install_(bucket, sv); \
+	while (bucket--); \
+} \
+size_t SV##_apushback(ELEMENT value, struct SV *sv) \
+{	size_t num = bbatomic_fetch_add(&sv->len, 1, BBATOMIC_RELAXED); \
+	size_t pos, bucket = bbsvector_bucket(num, &pos); \
+	SV##_install_(bucket, sv)[pos] = value; \
+	return num; \
+} \
+size_t SV##_agrowback(size_t num, struct SV *sv) \
+{	size_t first = bbatomic_fetch_add(&sv->len, num, BBATOMIC_RELAXED); \
+	if (num) \
+		SV##_areserveback(first + num, sv); \
+	return first; \
+} \
+bbstatic_semicolon
+
+/* Segmented Vector full. */
+#define SVECTOR(SV, ELEMENT, ALLOC, FREE) \
+	SVECTOR_INTERFACE(SV, ELEMENT, static BBUNUSED); \
+	SVECTOR_IMPLEMENTATION(SV, ELEMENT, ALLOC, FREE)
+
+#endif
@@ -8,12 +8,39 @@
 #undef NOINCLUDE
 #endif
 
+/*
+ * Instrumentation hooks of the automatic memory management.
+ * They expand to nothing unless BBMEMORY_STATS is defined (see `memory.h`).
+ */
+#ifdef BBMEMORY_STATS
+#  define BBVECTOR_STATS_DECLARATIONS(V, PREFIX) \
+	PREFIX struct bbmemory_stats *V##_stats(void);
+#  define BBVECTOR_STATS_IMPLEMENTATION(V) \
+	struct bbmemory_stats *V##_stats(void) \
+	{	static struct bbmemory_stats stats; \
+		return &stats; \
+	}
+#  define BBVECTOR_STATS_ALLOC(V, cap) \
+	bbmemory_stats_alloc((cap), V##_stats())
+#  define BBVECTOR_STATS_FREE(V) \
+	bbmemory_stats_free(V##_stats())
+#  define BBVECTOR_STATS_COPY(V, oldcap, newcap, bytes) \
+	bbmemory_stats_copy((oldcap), (newcap), (bytes), V##_stats())
+#else
+#  define BBVECTOR_STATS_DECLARATIONS(V, PREFIX)
+#  define BBVECTOR_STATS_IMPLEMENTATION(V)
+#  define BBVECTOR_STATS_ALLOC(V, cap) ((void)0)
+#  define BBVECTOR_STATS_FREE(V) ((void)0)
+#  define BBVECTOR_STATS_COPY(V, oldcap, newcap, bytes) ((void)0)
+#endif
+
 /*
  * Vector data structure.
  * 1. A type-creating macro has a prefix:
  *    `B` (Backward) -- push elements into the back end;
  *    `F` (Forward)  -- push elements into the front end;
- *    `Q` (Queue)    -- push elements into the both ends.
+ *    `Q` (Queue)    -- push elements into the both ends
+ *                      (the capacity is always a power of two).
  * 2. Core procedures provide manual memory management only.
  * 3. Structure members are a read-only part of the interface.
  *    You are to access the members, but do not modify them directly.
@@ -72,7 +99,10 @@ struct BV { \
 	ELEMENT *at; /* Beginning of memory and data. */ \
 }
 
-/* Backward Vector core procedures. */
+/*
+ * Backward Vector core procedures.
+ * The elements given to `insert` must not belong to the vector itself.
+ */
 #define BVECTOR_CORE_DECLARATIONS(BV, ELEMENT, PREFIX) \
 \
 PREFIX void BV##_init(ELEMENT *array, size_t cap, struct BV *bv); \
@@ -88,9 +118,18 @@ PREFIX void BV##_popback(struct BV *bv); \
 PREFIX void BV##_cutback(size_t num, struct BV *bv); \
 PREFIX void BV##_resizeback(size_t len, struct BV *bv); \
 PREFIX ELEMENT *BV##_back(struct BV *bv); \
+\
+PREFIX void BV##_appendback(ELEMENT const *array, size_t num, struct BV *bv); \
+PREFIX void BV##_insert(size_t pos, ELEMENT const *array, size_t num, \
+	struct BV *bv); \
+PREFIX void BV##_erase(size_t pos, size_t num, struct BV *bv); \
 bbstatic_semicolon
 
-/* Backward Vector automatic memory management appendix. */
+/*
+ * Backward Vector automatic memory management appendix.
+ * The elements given to `aappendback` may belong to the vector itself
+ * (they are found again if the memory moves), unlike those of `ainsert`.
+ */
 #define BVECTOR_AUTO_DECLARATIONS(BV, ELEMENT, PREFIX) \
 \
 PREFIX void BV##_ainit(size_t cap, struct BV *bv); \
@@ -101,6 +140,44 @@ PREFIX void BV##_areserveback(size_t cap, struct BV *bv); \
 PREFIX void BV##_apushback(ELEMENT value, struct BV *bv); \
 PREFIX ELEMENT *BV##_agrowback(size_t num, struct BV *bv); \
 PREFIX void BV##_aresizeback(size_t len, struct BV *bv); \
+PREFIX void BV##_ashrink(struct BV *bv); \
+\
+PREFIX void BV##_aappendback(ELEMENT const *array, size_t num, \
+	struct BV *bv); \
+PREFIX void BV##_ainsert(size_t pos, ELEMENT const *array, size_t num, \
+	struct BV *bv); \
+BBVECTOR_STATS_DECLARATIONS(BV, PREFIX) \
+bbstatic_semicolon
+
+/*
+ * Backward Vector automatic shrinking appendix.
+ * It requires the automatic memory management procedures.
+ */
+#define BVECTOR_SHRINK_DECLARATIONS(BV, ELEMENT, PREFIX) \
+\
+PREFIX void BV##_apopback(struct BV *bv); \
+PREFIX void BV##_acutback(size_t num, struct BV *bv); \
+PREFIX void BV##_aerase(size_t pos, size_t num, struct BV *bv); \
+bbstatic_semicolon
+
+/*
+ * Backward Vector fallible memory management appendix.
+ * It requires the core procedures only. The procedures return -1 (or NULL)
+ * instead of aborting when memory cannot be allocated, and keep the vector
+ * intact in that case. On success, they return 0 (or the elements).
+ * A growth by zero elements never fails, and its result may be NULL then
+ * (when the vector has no memory yet).
+ */
+#define BVECTOR_TRY_DECLARATIONS(BV, ELEMENT, PREFIX) \
+\
+PREFIX int BV##_tinit(size_t cap, struct BV *bv); \
+\
+PREFIX int BV##_treserveback(size_t cap, struct BV *bv); \
+PREFIX int BV##_tpushback(ELEMENT value, struct BV *bv); \
+PREFIX ELEMENT *BV##_tgrowback(size_t num, struct BV *bv); \
+PREFIX int BV##_tresizeback(size_t len, struct BV *bv); \
+PREFIX int BV##_tappendback(ELEMENT const *array, size_t num, \
+	struct BV *bv); \
 bbstatic_semicolon
 
 /* Backward Vector automatic memory management procedures. */
@@ -118,6 +195,31 @@ bbstatic_semicolon
 	BVECTOR_STRUCT(BV, ELEMENT); \
 	BVECTOR_DECLARATIONS(BV, ELEMENT, PREFIX)
 
+/****************************************
+ * Small Backward Vector interface.
+ ****************************************/
+
+/*
+ * Small Backward Vector embeds N elements into the structure and allocates
+ * memory only when they are not enough. Its procedures are the same as
+ * those of Backward Vector, so one can replace another by changing a macro.
+ * Do not copy the structure: the embedded elements may be in use.
+ */
+
+/* Small Backward Vector structure. */
+#define BVECTOR_SMALL_STRUCT(BV, ELEMENT, N) \
+\
+struct BV { \
+	size_t len, cap; /* Length and capacity. */ \
+	ELEMENT *at; /* Beginning of memory and data. */ \
+	ELEMENT buf[N]; /* Embedded memory. */ \
+}
+
+/* Small Backward Vector automatic memory management interface. */
+#define BVECTOR_SMALL_INTERFACE(BV, ELEMENT, N, PREFIX) \
+	BVECTOR_SMALL_STRUCT(BV, ELEMENT, N); \
+	BVECTOR_DECLARATIONS(BV, ELEMENT, PREFIX)
+
 /****************************************
  * Forward Vector interface.
  ****************************************/
@@ -130,7 +232,10 @@ struct FV { \
 	ELEMENT *neg; /* End of memory and data. */ \
 }
 
-/* Forward Vector core procedures. */
+/*
+ * Forward Vector core procedures.
+ * The elements given to `insert` must not belong to the vector itself.
+ */
 #define FVECTOR_CORE_DECLARATIONS(FV, ELEMENT, PREFIX) \
 \
 PREFIX void FV##_init(ELEMENT *array, size_t cap, struct FV *fv); \
@@ -146,9 +251,19 @@ PREFIX void FV##_popfront(struct FV *fv); \
 PREFIX void FV##_cutfront(size_t num, struct FV *fv); \
 PREFIX void FV##_resizefront(size_t len, struct FV *fv); \
 PREFIX ELEMENT *FV##_front(struct FV *fv); \
+\
+PREFIX void FV##_appendfront(ELEMENT const *array, size_t num, \
+	struct FV *fv); \
+PREFIX void FV##_insert(size_t pos, ELEMENT const *array, size_t num, \
+	struct FV *fv); \
+PREFIX void FV##_erase(size_t pos, size_t num, struct FV *fv); \
 bbstatic_semicolon
 
-/* Forward Vector automatic memory management appendix. */
+/*
+ * Forward Vector automatic memory management appendix.
+ * The elements given to `aappendfront` may belong to the vector itself
+ * (they are found again if the memory moves), unlike those of `ainsert`.
+ */
 #define FVECTOR_AUTO_DECLARATIONS(FV, ELEMENT, PREFIX) \
 \
 PREFIX void FV##_ainit(size_t cap, struct FV *fv); \
@@ -159,6 +274,44 @@ PREFIX void FV##_areservefront(size_t cap, struct FV *fv); \
 PREFIX void FV##_apushfront(ELEMENT value, struct FV *fv); \
 PREFIX ELEMENT *FV##_agrowfront(size_t num, struct FV *fv); \
 PREFIX void FV##_aresizefront(size_t len, struct FV *fv); \
+PREFIX void FV##_ashrink(struct FV *fv); \
+\
+PREFIX void FV##_aappendfront(ELEMENT const *array, size_t num, \
+	struct FV *fv); \
+PREFIX void FV##_ainsert(size_t pos, ELEMENT const *array, size_t num, \
+	struct FV *fv); \
+BBVECTOR_STATS_DECLARATIONS(FV, PREFIX) \
+bbstatic_semicolon
+
+/*
+ * Forward Vector automatic shrinking appendix.
+ * It requires the automatic memory management procedures.
+ */
+#define FVECTOR_SHRINK_DECLARATIONS(FV, ELEMENT, PREFIX) \
+\
+PREFIX void FV##_apopfront(struct FV *fv); \
+PREFIX void FV##_acutfront(size_t num, struct FV *fv); \
+PREFIX void FV##_aerase(size_t pos, size_t num, struct FV *fv); \
+bbstatic_semicolon
+
+/*
+ * Forward Vector fallible memory management appendix.
+ * It requires the core procedures only. The procedures return -1 (or NULL)
+ * instead of aborting when memory cannot be allocated, and keep the vector
+ * intact in that case. On success, they return 0 (or the elements).
+ * A growth by zero elements never fails, and its result may be NULL then
+ * (when the vector has no memory yet).
+ */
+#define FVECTOR_TRY_DECLARATIONS(FV, ELEMENT, PREFIX) \
+\
+PREFIX int FV##_tinit(size_t cap, struct FV *fv); \
+\
+PREFIX int FV##_treservefront(size_t cap, struct FV *fv); \
+PREFIX int FV##_tpushfront(ELEMENT value, struct FV *fv); \
+PREFIX ELEMENT *FV##_tgrowfront(size_t num, struct FV *fv); \
+PREFIX int FV##_tresizefront(size_t len, struct FV *fv); \
+PREFIX int FV##_tappendfront(ELEMENT const *array, size_t num, \
+	struct FV *fv); \
 bbstatic_semicolon
 
 /* Forward Vector automatic memory management procedures. */
@@ -176,6 +329,71 @@ bbstatic_semicolon
 	FVECTOR_STRUCT(FV, ELEMENT); \
 	FVECTOR_DECLARATIONS(FV, ELEMENT, PREFIX)
 
+/****************************************
+ * Queue Vector interface.
+ ****************************************/
+
+/* Queue Vector structure. */
+#define QVECTOR_STRUCT(QV, ELEMENT) \
+\
+struct QV { \
+	size_t len, cap; /* Length and capacity (a power of two or zero). */ \
+	size_t beg; /* Index of the first element in memory. */ \
+	ELEMENT *mem; /* Beginning of memory. */ \
+}
+
+/*
+ * Queue Vector core procedures.
+ * The capacity given to `init` and `reserve` must be a power of two
+ * (or zero): the indices wrap around by masking with `cap - 1`.
+ */
+#define QVECTOR_CORE_DECLARATIONS(QV, ELEMENT, PREFIX) \
+\
+PREFIX void QV##_init(ELEMENT *array, size_t cap, struct QV *qv); \
+PREFIX ELEMENT *QV##_fini(struct QV *qv); \
+PREFIX void QV##_clear(struct QV *qv); \
+PREFIX int QV##_full(struct QV *qv); \
+PREFIX ELEMENT *QV##_at(size_t num, struct QV *qv); \
+\
+PREFIX ELEMENT *QV##_reserve(ELEMENT *array, size_t cap, struct QV *qv); \
+PREFIX void QV##_pushback(ELEMENT value, struct QV *qv); \
+PREFIX void QV##_pushfront(ELEMENT value, struct QV *qv); \
+PREFIX void QV##_popback(struct QV *qv); \
+PREFIX void QV##_popfront(struct QV *qv); \
+PREFIX void QV##_cutback(size_t num, struct QV *qv); \
+PREFIX void QV##_cutfront(size_t num, struct QV *qv); \
+PREFIX ELEMENT *QV##_back(struct QV *qv); \
+PREFIX ELEMENT *QV##_front(struct QV *qv); \
+bbstatic_semicolon
+
+/* Queue Vector automatic memory management appendix. */
+#define QVECTOR_AUTO_DECLARATIONS(QV, ELEMENT, PREFIX) \
+\
+PREFIX void QV##_ainit(size_t cap, struct QV *qv); \
+PREFIX void QV##_afini(struct QV *qv); \
+PREFIX void QV##_aclear(struct QV *qv); \
+\
+PREFIX void QV##_areserve(size_t cap, struct QV *qv); \
+PREFIX void QV##_apushback(ELEMENT value, struct QV *qv); \
+PREFIX void QV##_apushfront(ELEMENT value, struct QV *qv); \
+BBVECTOR_STATS_DECLARATIONS(QV, PREFIX) \
+bbstatic_semicolon
+
+/* Queue Vector automatic memory management procedures. */
+#define QVECTOR_DECLARATIONS(QV, ELEMENT, PREFIX) \
+	QVECTOR_CORE_DECLARATIONS(QV, ELEMENT, PREFIX); \
+	QVECTOR_AUTO_DECLARATIONS(QV, ELEMENT, PREFIX)
+
+/* Queue Vector core interface. */
+#define QVECTOR_CORE_INTERFACE(QV, ELEMENT, PREFIX) \
+	QVECTOR_STRUCT(QV, ELEMENT); \
+	QVECTOR_CORE_DECLARATIONS(QV, ELEMENT, PREFIX)
+
+/* Queue Vector automatic memory management interface. */
+#define QVECTOR_INTERFACE(QV, ELEMENT, PREFIX) \
+	QVECTOR_STRUCT(QV, ELEMENT); \
+	QVECTOR_DECLARATIONS(QV, ELEMENT, PREFIX)
+
 /****************************************
  * Backward Vector implementation.
  ****************************************/
@@ -227,61 +445,284 @@ void BV##_resizeback(size_t len, struct BV *bv) \
 ELEMENT *BV##_back(struct BV *bv) \
 {	return &bv->at[bv->len - 1]; \
 } \
+void BV##_appendback(ELEMENT const *array, size_t num, struct BV *bv) \
+{	memcpy(&bv->at[bv->len], array, sizeof(ELEMENT) * num); \
+	bv->len += num; \
+} \
+void BV##_insert(size_t pos, ELEMENT const *array, size_t num, \
+	struct BV *bv) \
+{	ELEMENT *ptr = &bv->at[pos]; \
+	memmove(ptr + num, ptr, sizeof(ELEMENT) * (bv->len - pos)); \
+	memcpy(ptr, array, sizeof(ELEMENT) * num); \
+	bv->len += num; \
+} \
+void BV##_erase(size_t pos, size_t num, struct BV *bv) \
+{	ELEMENT *ptr = &bv->at[pos]; \
+	memmove(ptr, ptr + num, sizeof(ELEMENT) * (bv->len - pos - num)); \
+	bv->len -= num; \
+} \
+bbstatic_semicolon
+
+/* Backward Vector growth procedures (built on top of `areserveback`). */
+#define BVECTOR_GROWTH_IMPLEMENTATION(BV, ELEMENT, NEXT_CAP) \
+\
+void BV##_apushback(ELEMENT value, struct BV *bv) \
+{	if (BV##_full(bv)) \
+		BV##_areserveback(NEXT_CAP(bv->cap), bv); \
+	BV##_pushback(value, bv); \
+} \
+ELEMENT *BV##_agrowback(size_t num, struct BV *bv) \
+{	size_t len = bv->len + num; \
+	size_t cap = bv->cap; \
+	if (len > cap) { \
+		cap = NEXT_CAP(cap); \
+		if (len > cap) \
+			cap = len; \
+		BV##_areserveback(cap, bv); \
+	} \
+	return BV##_growback(num, bv); \
+} \
+void BV##_aresizeback(size_t len, struct BV *bv) \
+{	size_t cap = bv->cap; \
+	if (len > cap) { \
+		cap = NEXT_CAP(cap); \
+		if (len > cap) \
+			cap = len; \
+		BV##_areserveback(cap, bv); \
+	} \
+	bv->len = len; \
+} \
+void BV##_ashrink(struct BV *bv) \
+{	if (bv->len < bv->cap) \
+		BV##_areserveback(bv->len, bv); \
+} \
+void BV##_aappendback(ELEMENT const *array, size_t num, struct BV *bv) \
+{	size_t len = bv->len + num; \
+	size_t cap = bv->cap; \
+	if (len > cap) { \
+		/* Offset of the elements if they belong to the vector. */ \
+		size_t off = bv->len && array >= bv->at && \
+			array < bv->at + bv->len ? (size_t)(array - bv->at) : len; \
+		cap = NEXT_CAP(cap); \
+		if (len > cap) \
+			cap = len; \
+		BV##_areserveback(cap, bv); \
+		if (off < len) \
+			array = bv->at + off; \
+	} \
+	BV##_appendback(array, num, bv); \
+} \
+void BV##_ainsert(size_t pos, ELEMENT const *array, size_t num, \
+	struct BV *bv) \
+{	size_t len = bv->len + num; \
+	size_t cap = bv->cap; \
+	if (len > cap) { \
+		cap = NEXT_CAP(cap); \
+		if (len > cap) \
+			cap = len; \
+		BV##_areserveback(cap, bv); \
+	} \
+	BV##_insert(pos, array, num, bv); \
+} \
 bbstatic_semicolon
 
 /* Backward Vector automatic memory management appendix. */
 #define BVECTOR_AUTO_IMPLEMENTATION(BV, ELEMENT, ALLOC, FREE, NEXT_CAP) \
 \
+BBVECTOR_STATS_IMPLEMENTATION(BV) \
 void BV##_ainit(size_t cap, struct BV *bv) \
 {	ELEMENT *ptr = ALLOC(cap, sizeof(ELEMENT)); \
+	BBVECTOR_STATS_ALLOC(BV, cap); \
 	BV##_init(ptr, cap, bv); \
 } \
 void BV##_afini(struct BV *bv) \
-{	FREE(BV##_fini(bv)); \
+{	BBVECTOR_STATS_FREE(BV); \
+	FREE(BV##_fini(bv)); \
 } \
 void BV##_aclear(struct BV *bv) \
-{	FREE(bv->at); \
+{	BBVECTOR_STATS_FREE(BV); \
+	FREE(bv->at); \
 	bv->at = NULL; \
 	bv->len = 0; \
 	bv->cap = 0; \
 } \
 void BV##_areserveback(size_t cap, struct BV *bv) \
 {	ELEMENT *ptr = ALLOC(cap, sizeof(ELEMENT)); \
+	BBVECTOR_STATS_ALLOC(BV, cap); \
+	BBVECTOR_STATS_FREE(BV); \
+	BBVECTOR_STATS_COPY(BV, bv->cap, cap, sizeof(ELEMENT) * bv->len); \
 	FREE(BV##_reserveback(ptr, cap, bv)); \
 } \
-void BV##_apushback(ELEMENT value, struct BV *bv) \
-{	if (BV##_full(bv)) \
-		BV##_areserveback(NEXT_CAP(bv->cap), bv); \
+BVECTOR_GROWTH_IMPLEMENTATION(BV, ELEMENT, NEXT_CAP)
+
+/*
+ * Backward Vector automatic memory management appendix (reallocating).
+ * REALLOC(ptr, len, size) must accept NULL and keep the contents like
+ * `realloc()` does. The memory is extended in place when possible, so the
+ * growth does not copy the whole vector and does not double the peak usage.
+ */
+#define BVECTOR_REALLOC_AUTO_IMPLEMENTATION(BV, ELEMENT, REALLOC, FREE, \
+	NEXT_CAP) \
+\
+BBVECTOR_STATS_IMPLEMENTATION(BV) \
+void BV##_ainit(size_t cap, struct BV *bv) \
+{	ELEMENT *ptr = REALLOC(NULL, cap, sizeof(ELEMENT)); \
+	BBVECTOR_STATS_ALLOC(BV, cap); \
+	BV##_init(ptr, cap, bv); \
+} \
+void BV##_afini(struct BV *bv) \
+{	BBVECTOR_STATS_FREE(BV); \
+	FREE(BV##_fini(bv)); \
+} \
+void BV##_aclear(struct BV *bv) \
+{	BBVECTOR_STATS_FREE(BV); \
+	FREE(bv->at); \
+	bv->at = NULL; \
+	bv->len = 0; \
+	bv->cap = 0; \
+} \
+void BV##_areserveback(size_t cap, struct BV *bv) \
+{	ELEMENT *ptr = REALLOC(bv->at, cap, sizeof(ELEMENT)); \
+	BBVECTOR_STATS_ALLOC(BV, cap); \
+	BBVECTOR_STATS_FREE(BV); \
+	BBVECTOR_STATS_COPY(BV, bv->cap, cap, \
+		ptr != bv->at ? sizeof(ELEMENT) * bv->len : 0); \
+	bv->at = ptr; \
+	bv->cap = cap; \
+} \
+BVECTOR_GROWTH_IMPLEMENTATION(BV, ELEMENT, NEXT_CAP)
+
+/*
+ * Backward Vector automatic shrinking appendix.
+ * SHRINK_CAP(len, cap) returns the new capacity (not less than `len`),
+ * or `cap` if the memory should be kept.
+ */
+#define BVECTOR_SHRINK_IMPLEMENTATION(BV, ELEMENT, SHRINK_CAP) \
+\
+void BV##_apopback(struct BV *bv) \
+{	size_t cap; \
+	BV##_popback(bv); \
+	cap = SHRINK_CAP(bv->len, bv->cap); \
+	if (cap < bv->cap) \
+		BV##_areserveback(cap, bv); \
+} \
+void BV##_acutback(size_t num, struct BV *bv) \
+{	size_t cap; \
+	BV##_cutback(num, bv); \
+	cap = SHRINK_CAP(bv->len, bv->cap); \
+	if (cap < bv->cap) \
+		BV##_areserveback(cap, bv); \
+} \
+void BV##_aerase(size_t pos, size_t num, struct BV *bv) \
+{	size_t cap; \
+	BV##_erase(pos, num, bv); \
+	cap = SHRINK_CAP(bv->len, bv->cap); \
+	if (cap < bv->cap) \
+		BV##_areserveback(cap, bv); \
+} \
+bbstatic_semicolon
+
+/* Backward Vector fallible growth procedures (built on `treserveback`). */
+#define BVECTOR_TRY_GROWTH_IMPLEMENTATION(BV, ELEMENT, NEXT_CAP) \
+\
+int BV##_tpushback(ELEMENT value, struct BV *bv) \
+{	if (BV##_full(bv) && BV##_treserveback(NEXT_CAP(bv->cap), bv)) \
+		return -1; \
 	BV##_pushback(value, bv); \
+	return 0; \
 } \
-ELEMENT *BV##_agrowback(size_t num, struct BV *bv) \
+ELEMENT *BV##_tgrowback(size_t num, struct BV *bv) \
 {	size_t len = bv->len + num; \
-	size_t cap = bv->cap; \
-	if (len > cap) { \
-		cap = NEXT_CAP(cap); \
-		if (len > cap) \
-			cap = len; \
-		BV##_areserveback(cap, bv); \
-	} \
-	return BV##_growback(num, bv); \
+	if (len < num) /* Check for integer overflow. */ \
+		return NULL; \
+	if (BV##_tresizeback(len, bv)) \
+		return NULL; \
+	return BV##_neg(num, bv); \
 } \
-void BV##_aresizeback(size_t len, struct BV *bv) \
+int BV##_tresizeback(size_t len, struct BV *bv) \
 {	size_t cap = bv->cap; \
 	if (len > cap) { \
 		cap = NEXT_CAP(cap); \
 		if (len > cap) \
 			cap = len; \
-		BV##_areserveback(cap, bv); \
+		if (BV##_treserveback(cap, bv)) \
+			return -1; \
 	} \
 	bv->len = len; \
+	return 0; \
+} \
+int BV##_tappendback(ELEMENT const *array, size_t num, struct BV *bv) \
+{	size_t len = bv->len + num; \
+	/* Offset of the elements if they belong to the vector. */ \
+	size_t off = bv->len && array >= bv->at && \
+		array < bv->at + bv->len ? (size_t)(array - bv->at) : len; \
+	if (num == 0) \
+		return 0; \
+	if (len < num || BV##_tresizeback(len, bv)) \
+		return -1; \
+	if (off < len) \
+		array = bv->at + off; \
+	memcpy(BV##_neg(num, bv), array, sizeof(ELEMENT) * num); \
+	return 0; \
 } \
 bbstatic_semicolon
 
+/*
+ * Backward Vector fallible memory management appendix.
+ * TRY_ALLOC returns NULL on failure. NEXT_CAP must not abort either.
+ */
+#define BVECTOR_TRY_IMPLEMENTATION(BV, ELEMENT, TRY_ALLOC, FREE, NEXT_CAP) \
+\
+int BV##_tinit(size_t cap, struct BV *bv) \
+{	ELEMENT *ptr = TRY_ALLOC(cap, sizeof(ELEMENT)); \
+	if (!ptr && cap != 0) \
+		return -1; \
+	BV##_init(ptr, cap, bv); \
+	return 0; \
+} \
+int BV##_treserveback(size_t cap, struct BV *bv) \
+{	ELEMENT *ptr = TRY_ALLOC(cap, sizeof(ELEMENT)); \
+	if (!ptr && cap != 0) \
+		return -1; \
+	FREE(BV##_reserveback(ptr, cap, bv)); \
+	return 0; \
+} \
+BVECTOR_TRY_GROWTH_IMPLEMENTATION(BV, ELEMENT, NEXT_CAP)
+
+/*
+ * Backward Vector fallible memory management appendix (reallocating).
+ * TRY_REALLOC returns NULL on failure and keeps the old memory then.
+ */
+#define BVECTOR_TRY_REALLOC_IMPLEMENTATION(BV, ELEMENT, TRY_REALLOC, \
+	NEXT_CAP) \
+\
+int BV##_tinit(size_t cap, struct BV *bv) \
+{	ELEMENT *ptr = TRY_REALLOC(NULL, cap, sizeof(ELEMENT)); \
+	if (!ptr && cap != 0) \
+		return -1; \
+	BV##_init(ptr, cap, bv); \
+	return 0; \
+} \
+int BV##_treserveback(size_t cap, struct BV *bv) \
+{	ELEMENT *ptr = TRY_REALLOC(bv->at, cap, sizeof(ELEMENT)); \
+	if (!ptr && cap != 0) \
+		return -1; \
+	bv->at = ptr; \
+	bv->cap = cap; \
+	return 0; \
+} \
+BVECTOR_TRY_GROWTH_IMPLEMENTATION(BV, ELEMENT, NEXT_CAP)
+
 /* Backward Vector automatic memory management procedures. */
 #define BVECTOR_IMPLEMENTATION(BV, ELEMENT, ALLOC, FREE, NEXT_CAP) \
 	BVECTOR_CORE_IMPLEMENTATION(BV, ELEMENT); \
 	BVECTOR_AUTO_IMPLEMENTATION(BV, ELEMENT, ALLOC, FREE, NEXT_CAP)
 
+/* Backward Vector automatic memory management procedures (reallocating). */
+#define BVECTOR_REALLOC_IMPLEMENTATION(BV, ELEMENT, REALLOC, FREE, NEXT_CAP) \
+	BVECTOR_CORE_IMPLEMENTATION(BV, ELEMENT); \
+	BVECTOR_REALLOC_AUTO_IMPLEMENTATION(BV, ELEMENT, REALLOC, FREE, NEXT_CAP)
+
 /* Backward Vector core full. */
 #define BVECTOR_CORE(BV, ELEMENT) \
 	BVECTOR_CORE_INTERFACE(BV, ELEMENT, static BBUNUSED); \
@@ -292,6 +733,86 @@ bbstatic_semicolon
 	BVECTOR_INTERFACE(BV, ELEMENT, static BBUNUSED); \
 	BVECTOR_IMPLEMENTATION(BV, ELEMENT, ALLOC, FREE, NEXT_CAP)
 
+/* Backward Vector automatic shrinking appendix full. */
+#define BVECTOR_SHRINK(BV, ELEMENT, SHRINK_CAP) \
+	BVECTOR_SHRINK_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	BVECTOR_SHRINK_IMPLEMENTATION(BV, ELEMENT, SHRINK_CAP)
+
+/* Backward Vector fallible memory management appendix full. */
+#define BVECTOR_TRY(BV, ELEMENT, TRY_ALLOC, FREE, NEXT_CAP) \
+	BVECTOR_TRY_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	BVECTOR_TRY_IMPLEMENTATION(BV, ELEMENT, TRY_ALLOC, FREE, NEXT_CAP)
+
+/* Backward Vector fallible memory management appendix full (reallocating). */
+#define BVECTOR_TRY_REALLOC(BV, ELEMENT, TRY_REALLOC, NEXT_CAP) \
+	BVECTOR_TRY_DECLARATIONS(BV, ELEMENT, static BBUNUSED); \
+	BVECTOR_TRY_REALLOC_IMPLEMENTATION(BV, ELEMENT, TRY_REALLOC, NEXT_CAP)
+
+/* Backward Vector automatic memory management full (reallocating). */
+#define BVECTOR_REALLOC(BV, ELEMENT, REALLOC, FREE, NEXT_CAP) \
+	BVECTOR_INTERFACE(BV, ELEMENT, static BBUNUSED); \
+	BVECTOR_REALLOC_IMPLEMENTATION(BV, ELEMENT, REALLOC, FREE, NEXT_CAP)
+
+/****************************************
+ * Small Backward Vector implementation.
+ ****************************************/
+
+/* Small Backward Vector automatic memory management appendix. */
+#define BVECTOR_SMALL_AUTO_IMPLEMENTATION(BV, ELEMENT, N, ALLOC, FREE, \
+	NEXT_CAP) \
+\
+BBVECTOR_STATS_IMPLEMENTATION(BV) \
+void BV##_ainit(size_t cap, struct BV *bv) \
+{	if (cap <= N) { \
+		BV##_init(bv->buf, N, bv); \
+	} else { \
+		BBVECTOR_STATS_ALLOC(BV, cap); \
+		BV##_init(ALLOC(cap, sizeof(ELEMENT)), cap, bv); \
+	} \
+} \
+void BV##_afini(struct BV *bv) \
+{	ELEMENT *ptr = BV##_fini(bv); \
+	if (ptr != bv->buf) { \
+		BBVECTOR_STATS_FREE(BV); \
+		FREE(ptr); \
+	} \
+} \
+void BV##_aclear(struct BV *bv) \
+{	if (bv->at != bv->buf) { \
+		BBVECTOR_STATS_FREE(BV); \
+		FREE(bv->at); \
+	} \
+	BV##_init(bv->buf, N, bv); \
+} \
+void BV##_areserveback(size_t cap, struct BV *bv) \
+{	ELEMENT *old; \
+	if (cap <= N) { \
+		if (bv->at == bv->buf) \
+			return; \
+		BBVECTOR_STATS_COPY(BV, bv->cap, N, sizeof(ELEMENT) * bv->len); \
+		old = BV##_reserveback(bv->buf, N, bv); \
+	} else { \
+		BBVECTOR_STATS_ALLOC(BV, cap); \
+		BBVECTOR_STATS_COPY(BV, bv->cap, cap, sizeof(ELEMENT) * bv->len); \
+		old = BV##_reserveback(ALLOC(cap, sizeof(ELEMENT)), cap, bv); \
+	} \
+	if (old != bv->buf) { \
+		BBVECTOR_STATS_FREE(BV); \
+		FREE(old); \
+	} \
+} \
+BVECTOR_GROWTH_IMPLEMENTATION(BV, ELEMENT, NEXT_CAP)
+
+/* Small Backward Vector automatic memory management procedures. */
+#define BVECTOR_SMALL_IMPLEMENTATION(BV, ELEMENT, N, ALLOC, FREE, NEXT_CAP) \
+	BVECTOR_CORE_IMPLEMENTATION(BV, ELEMENT); \
+	BVECTOR_SMALL_AUTO_IMPLEMENTATION(BV, ELEMENT, N, ALLOC, FREE, NEXT_CAP)
+
+/* Small Backward Vector automatic memory management full. */
+#define BVECTOR_SMALL(BV, ELEMENT, N, ALLOC, FREE, NEXT_CAP) \
+	BVECTOR_SMALL_INTERFACE(BV, ELEMENT, N, static BBUNUSED); \
+	BVECTOR_SMALL_IMPLEMENTATION(BV, ELEMENT, N, ALLOC, FREE, NEXT_CAP)
+
 /****************************************
  * Forward Vector implementation.
  ****************************************/
@@ -344,26 +865,49 @@ void FV##_resizefront(size_t len, struct FV *fv) \
 ELEMENT *FV##_front(struct FV *fv) \
 {	return fv->neg - fv->len; \
 } \
+void FV##_appendfront(ELEMENT const *array, size_t num, struct FV *fv) \
+{	fv->len += num; \
+	memcpy(fv->neg - fv->len, array, sizeof(ELEMENT) * num); \
+} \
+void FV##_insert(size_t pos, ELEMENT const *array, size_t num, \
+	struct FV *fv) \
+{	ELEMENT *ptr = fv->neg - fv->len; \
+	memmove(ptr - num, ptr, sizeof(ELEMENT) * pos); \
+	memcpy(ptr - num + pos, array, sizeof(ELEMENT) * num); \
+	fv->len += num; \
+} \
+void FV##_erase(size_t pos, size_t num, struct FV *fv) \
+{	ELEMENT *ptr = fv->neg - fv->len; \
+	memmove(ptr + num, ptr, sizeof(ELEMENT) * pos); \
+	fv->len -= num; \
+} \
 bbstatic_semicolon
 
 /* Forward Vector automatic memory management appendix. */
 #define FVECTOR_AUTO_IMPLEMENTATION(FV, ELEMENT, ALLOC, FREE, NEXT_CAP) \
 \
+BBVECTOR_STATS_IMPLEMENTATION(FV) \
 void FV##_ainit(size_t cap, struct FV *fv) \
 {	ELEMENT *ptr = ALLOC(cap, sizeof(ELEMENT)); \
+	BBVECTOR_STATS_ALLOC(FV, cap); \
 	FV##_init(ptr, cap, fv); \
 } \
 void FV##_afini(struct FV *fv) \
-{	FREE(FV##_fini(fv)); \
+{	BBVECTOR_STATS_FREE(FV); \
+	FREE(FV##_fini(fv)); \
 } \
 void FV##_aclear(struct FV *fv) \
-{	FREE(fv->neg - fv->cap); \
+{	BBVECTOR_STATS_FREE(FV); \
+	FREE(fv->neg - fv->cap); \
 	fv->neg = NULL; \
 	fv->len = 0; \
 	fv->cap = 0; \
 } \
 void FV##_areservefront(size_t cap, struct FV *fv) \
 {	ELEMENT *ptr = ALLOC(cap, sizeof(ELEMENT)); \
+	BBVECTOR_STATS_ALLOC(FV, cap); \
+	BBVECTOR_STATS_FREE(FV); \
+	BBVECTOR_STATS_COPY(FV, fv->cap, cap, sizeof(ELEMENT) * fv->len); \
 	FREE(FV##_reservefront(ptr, cap, fv)); \
 } \
 void FV##_apushfront(ELEMENT value, struct FV *fv) \
@@ -392,6 +936,130 @@ void FV##_aresizefront(size_t len, struct FV *fv) \
 	} \
 	fv->len = len; \
 } \
+void FV##_ashrink(struct FV *fv) \
+{	if (fv->len < fv->cap) \
+		FV##_areservefront(fv->len, fv); \
+} \
+void FV##_aappendfront(ELEMENT const *array, size_t num, struct FV *fv) \
+{	size_t len = fv->len + num; \
+	size_t cap = fv->cap; \
+	if (len > cap) { \
+		/* Offset of the elements if they belong to the vector. */ \
+		size_t off = fv->len && array >= fv->neg - fv->len && \
+			array < fv->neg ? (size_t)(fv->neg - array) : 0; \
+		cap = NEXT_CAP(cap); \
+		if (len > cap) \
+			cap = len; \
+		FV##_areservefront(cap, fv); \
+		if (off) \
+			array = fv->neg - off; \
+	} \
+	FV##_appendfront(array, num, fv); \
+} \
+void FV##_ainsert(size_t pos, ELEMENT const *array, size_t num, \
+	struct FV *fv) \
+{	size_t len = fv->len + num; \
+	size_t cap = fv->cap; \
+	if (len > cap) { \
+		cap = NEXT_CAP(cap); \
+		if (len > cap) \
+			cap = len; \
+		FV##_areservefront(cap, fv); \
+	} \
+	FV##_insert(pos, array, num, fv); \
+} \
+bbstatic_semicolon
+
+/*
+ * Forward Vector automatic shrinking appendix.
+ * SHRINK_CAP(len, cap) returns the new capacity (not less than `len`),
+ * or `cap` if the memory should be kept.
+ */
+#define FVECTOR_SHRINK_IMPLEMENTATION(FV, ELEMENT, SHRINK_CAP) \
+\
+void FV##_apopfront(struct FV *fv) \
+{	size_t cap; \
+	FV##_popfront(fv); \
+	cap = SHRINK_CAP(fv->len, fv->cap); \
+	if (cap < fv->cap) \
+		FV##_areservefront(cap, fv); \
+} \
+void FV##_acutfront(size_t num, struct FV *fv) \
+{	size_t cap; \
+	FV##_cutfront(num, fv); \
+	cap = SHRINK_CAP(fv->len, fv->cap); \
+	if (cap < fv->cap) \
+		FV##_areservefront(cap, fv); \
+} \
+void FV##_aerase(size_t pos, size_t num, struct FV *fv) \
+{	size_t cap; \
+	FV##_erase(pos, num, fv); \
+	cap = SHRINK_CAP(fv->len, fv->cap); \
+	if (cap < fv->cap) \
+		FV##_areservefront(cap, fv); \
+} \
+bbstatic_semicolon
+
+/*
+ * Forward Vector fallible memory management appendix.
+ * TRY_ALLOC returns NULL on failure. NEXT_CAP must not abort either.
+ */
+#define FVECTOR_TRY_IMPLEMENTATION(FV, ELEMENT, TRY_ALLOC, FREE, NEXT_CAP) \
+\
+int FV##_tinit(size_t cap, struct FV *fv) \
+{	ELEMENT *ptr = TRY_ALLOC(cap, sizeof(ELEMENT)); \
+	if (!ptr && cap != 0) \
+		return -1; \
+	FV##_init(ptr, cap, fv); \
+	return 0; \
+} \
+int FV##_treservefront(size_t cap, struct FV *fv) \
+{	ELEMENT *ptr = TRY_ALLOC(cap, sizeof(ELEMENT)); \
+	if (!ptr && cap != 0) \
+		return -1; \
+	FREE(FV##_reservefront(ptr, cap, fv)); \
+	return 0; \
+} \
+int FV##_tpushfront(ELEMENT value, struct FV *fv) \
+{	if (FV##_full(fv) && FV##_treservefront(NEXT_CAP(fv->cap), fv)) \
+		return -1; \
+	FV##_pushfront(value, fv); \
+	return 0; \
+} \
+ELEMENT *FV##_tgrowfront(size_t num, struct FV *fv) \
+{	size_t len = fv->len + num; \
+	if (len < num) /* Check for integer overflow. */ \
+		return NULL; \
+	if (FV##_tresizefront(len, fv)) \
+		return NULL; \
+	return FV##_front(fv); \
+} \
+int FV##_tresizefront(size_t len, struct FV *fv) \
+{	size_t cap = fv->cap; \
+	if (len > cap) { \
+		cap = NEXT_CAP(cap); \
+		if (len > cap) \
+			cap = len; \
+		if (FV##_treservefront(cap, fv)) \
+			return -1; \
+	} \
+	fv->len = len; \
+	return 0; \
+} \
+int FV##_tappendfront(ELEMENT const *array, size_t num, struct FV *fv) \
+{	size_t len = fv->len + num; \
+	/* Offset of the elements if they belong to the vector. */ \
+	size_t off = fv->len && array >= fv->neg - fv->len && \
+		array < fv->neg ? (size_t)(fv->neg - array) : 0; \
+	if (num == 0) \
+		return 0; \
+	if (len < num || FV##_tresizefront(len, fv)) \
+		return -1; \
+	if (off) \
+		array = fv->neg - off; \
+	memcpy(FV##_front(fv), array, sizeof(ELEMENT) * num); \
+	return 0; \
+} \
 bbstatic_semicolon
 
 /* Forward Vector automatic memory management procedures. */
@@ -409,6 +1077,165 @@ bbstatic_semicolon
 	FVECTOR_INTERFACE(FV, ELEMENT, static BBUNUSED); \
 	FVECTOR_IMPLEMENTATION(FV, ELEMENT, ALLOC, FREE, NEXT_CAP)
 
+/* Forward Vector fallible memory management appendix full. */
+#define FVECTOR_TRY(FV, ELEMENT, TRY_ALLOC, FREE, NEXT_CAP) \
+	FVECTOR_TRY_DECLARATIONS(FV, ELEMENT, static BBUNUSED); \
+	FVECTOR_TRY_IMPLEMENTATION(FV, ELEMENT, TRY_ALLOC, FREE, NEXT_CAP)
+
+/* Forward Vector automatic shrinking appendix full. */
+#define FVECTOR_SHRINK(FV, ELEMENT, SHRINK_CAP) \
+	FVECTOR_SHRINK_DECLARATIONS(FV, ELEMENT, static BBUNUSED); \
+	FVECTOR_SHRINK_IMPLEMENTATION(FV, ELEMENT, SHRINK_CAP)
+
+/****************************************
+ * Queue Vector implementation.
+ ****************************************/
+
+/*
+ * Round a capacity up to a power of two (zero stays zero).
+ * On overflow, return the maximum value no allocator can satisfy.
+ */
+static BBUNUSED size_t bbvector_pow2(size_t cap)
+{
+	size_t pow = 1;
+
+	if (cap == 0)
+		return 0;
+	while (pow < cap) {
+		pow <<= 1;
+		if (pow == 0) /* Check for integer overflow. */
+			return (size_t)-1;
+	}
+	return pow;
+}
+
+/* Queue Vector core procedures. */
+#define QVECTOR_CORE_IMPLEMENTATION(QV, ELEMENT) \
+\
+void QV##_init(ELEMENT *array, size_t cap, struct QV *qv) \
+{	qv->mem = array; \
+	qv->beg = 0; \
+	qv->len = 0; \
+	qv->cap = cap; \
+} \
+ELEMENT *QV##_fini(struct QV *qv) \
+{	return qv->mem; \
+} \
+void QV##_clear(struct QV *qv) \
+{	qv->beg = 0; \
+	qv->len = 0; \
+} \
+int QV##_full(struct QV *qv) \
+{	return qv->len == qv->cap; \
+} \
+ELEMENT *QV##_at(size_t num, struct QV *qv) \
+{	return &qv->mem[(qv->beg + num) & (qv->cap - 1)]; \
+} \
+ELEMENT *QV##_reserve(ELEMENT *array, size_t cap, struct QV *qv) \
+{	ELEMENT *old = qv->mem; \
+	size_t len = qv->len; \
+	size_t head = qv->cap - qv->beg; /* Elements before the wrap. */ \
+	if (head >= len) { \
+		memcpy(array, &old[qv->beg], sizeof(ELEMENT) * len); \
+	} else { \
+		memcpy(array, &old[qv->beg], sizeof(ELEMENT) * head); \
+		memcpy(&array[head], old, sizeof(ELEMENT) * (len - head)); \
+	} \
+	qv->mem = array; \
+	qv->beg = 0; \
+	qv->cap = cap; \
+	return old; \
+} \
+void QV##_pushback(ELEMENT value, struct QV *qv) \
+{	qv->mem[(qv->beg + qv->len++) & (qv->cap - 1)] = value; \
+} \
+void QV##_pushfront(ELEMENT value, struct QV *qv) \
+{	qv->beg = (qv->beg - 1) & (qv->cap - 1); \
+	qv->mem[qv->beg] = value; \
+	qv->len++; \
+} \
+void QV##_popback(struct QV *qv) \
+{	qv->len--; \
+} \
+void QV##_popfront(struct QV *qv) \
+{	qv->beg = (qv->beg + 1) & (qv->cap - 1); \
+	qv->len--; \
+} \
+void QV##_cutback(size_t num, struct QV *qv) \
+{	qv->len -= num; \
+} \
+void QV##_cutfront(size_t num, struct QV *qv) \
+{	qv->beg = (qv->beg + num) & (qv->cap - 1); \
+	qv->len -= num; \
+} \
+ELEMENT *QV##_back(struct QV *qv) \
+{	return &qv->mem[(qv->beg + qv->len - 1) & (qv->cap - 1)]; \
+} \
+ELEMENT *QV##_front(struct QV *qv) \
+{	return &qv->mem[qv->beg]; \
+} \
+bbstatic_semicolon
+
+/* Queue Vector automatic memory management appendix.
+ * The capacity returned by NEXT_CAP is rounded up to a power of two. */
+#define QVECTOR_AUTO_IMPLEMENTATION(QV, ELEMENT, ALLOC, FREE, NEXT_CAP) \
+\
+BBVECTOR_STATS_IMPLEMENTATION(QV) \
+void QV##_ainit(size_t cap, struct QV *qv) \
+{	ELEMENT *ptr; \
+	cap = bbvector_pow2(cap); \
+	ptr = ALLOC(cap, sizeof(ELEMENT)); \
+	BBVECTOR_STATS_ALLOC(QV, cap); \
+	QV##_init(ptr, cap, qv); \
+} \
+void QV##_afini(struct QV *qv) \
+{	BBVECTOR_STATS_FREE(QV); \
+	FREE(QV##_fini(qv)); \
+} \
+void QV##_aclear(struct QV *qv) \
+{	BBVECTOR_STATS_FREE(QV); \
+	FREE(qv->mem); \
+	qv->mem = NULL; \
+	qv->beg = 0; \
+	qv->len = 0; \
+	qv->cap = 0; \
+} \
+void QV##_areserve(size_t cap, struct QV *qv) \
+{	ELEMENT *ptr; \
+	cap = bbvector_pow2(cap); \
+	ptr = ALLOC(cap, sizeof(ELEMENT)); \
+	BBVECTOR_STATS_ALLOC(QV, cap); \
+	BBVECTOR_STATS_FREE(QV); \
+	BBVECTOR_STATS_COPY(QV, qv->cap, cap, sizeof(ELEMENT) * qv->len); \
+	FREE(QV##_reserve(ptr, cap, qv)); \
+} \
+void QV##_apushback(ELEMENT value, struct QV *qv) \
+{	if (QV##_full(qv)) \
+		QV##_areserve(NEXT_CAP(qv->cap), qv); \
+	QV##_pushback(value, qv); \
+} \
+void QV##_apushfront(ELEMENT value, struct QV *qv) \
+{	if (QV##_full(qv)) \
+		QV##_areserve(NEXT_CAP(qv->cap), qv); \
+	QV##_pushfront(value, qv); \
+} \
+bbstatic_semicolon
+
+/* Queue Vector automatic memory management procedures. */
+#define QVECTOR_IMPLEMENTATION(QV, ELEMENT, ALLOC, FREE, NEXT_CAP) \
+	QVECTOR_CORE_IMPLEMENTATION(QV, ELEMENT); \
+	QVECTOR_AUTO_IMPLEMENTATION(QV, ELEMENT, ALLOC, FREE, NEXT_CAP)
+
+/* Queue Vector core full. */
+#define QVECTOR_CORE(QV, ELEMENT) \
+	QVECTOR_CORE_INTERFACE(QV, ELEMENT, static BBUNUSED); \
+	QVECTOR_CORE_IMPLEMENTATION(QV, ELEMENT)
+
+/* Queue Vector automatic memory management full. */
+#define QVECTOR(QV, ELEMENT, ALLOC, FREE, NEXT_CAP) \
+	QVECTOR_INTERFACE(QV, ELEMENT, static BBUNUSED); \
+	QVECTOR_IMPLEMENTATION(QV, ELEMENT, ALLOC, FREE, NEXT_CAP)
+
 /****************************************
  * Legacy.
  ****************************************/
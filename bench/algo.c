@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/algo.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Sorting and searching with the inlined comparisons compared with
+ * `qsort()` and `bsearch()` calling a comparator.
+ */
+
+/* Number of elements sorted. */
+#define BENCH_ELEMENTS ((size_t)1 << 20)
+
+/* Number of lookups in a run. */
+#define BENCH_LOOKUPS ((size_t)1 << 22)
+
+#define bench_less(num1, num2) ((num1) < (num2))
+#define bench_key(num) ((unsigned long)(num))
+
+BVECTOR_DEFAULT(bench_vec, unsigned);
+BVECTOR_ALGO(bench_vec, unsigned, bench_less);
+BVECTOR_RADIX(bench_vec, unsigned, bench_key);
+
+/* Keep the results alive. */
+static volatile size_t bench_sink;
+
+/* Time since the start of the run. */
+static double bench_time(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Print a result line. */
+static void bench_print(const char *op, const char *kind, size_t num,
+	double sec)
+{
+	printf("%-8s %-15s %8.2f ns/element\n", op, kind, sec * 1e9 / num);
+}
+
+/* Pseudo-random sequence. */
+static unsigned long bench_next(unsigned long *state)
+{
+	*state = (*state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+	return *state >> 1;
+}
+
+static int bench_cmp(const void *num1, const void *num2)
+{
+	unsigned u1 = *(const unsigned *)num1;
+	unsigned u2 = *(const unsigned *)num2;
+
+	return (u1 > u2) - (u1 < u2);
+}
+
+/* Fill the vector with the same random numbers. */
+static void bench_fill(struct bench_vec *vec)
+{
+	unsigned long state = 1;
+	size_t num;
+
+	bench_vec_clear(vec);
+	for (num = 0; num < BENCH_ELEMENTS; num++)
+		bench_vec_apushback((unsigned)bench_next(&state), vec);
+}
+
+int main(void)
+{
+	struct bench_vec vec, ref;
+	unsigned *tmp = bbmemory_alloc(BENCH_ELEMENTS, sizeof(unsigned));
+	unsigned long state = 2;
+	clock_t start;
+	size_t num, found;
+	int err = 0;
+
+	bench_vec_ainit(BENCH_ELEMENTS, &vec);
+	bench_vec_ainit(BENCH_ELEMENTS, &ref);
+
+	puts("Sorting (random 31-bit keys):");
+	bench_fill(&ref);
+	start = clock();
+	qsort(ref.at, ref.len, sizeof(unsigned), bench_cmp);
+	bench_print("sort", "qsort", BENCH_ELEMENTS, bench_time(start));
+
+	bench_fill(&vec);
+	start = clock();
+	bench_vec_sort(&vec);
+	bench_print("sort", "introsort", BENCH_ELEMENTS, bench_time(start));
+	err |= memcmp(vec.at, ref.at, sizeof(unsigned) * vec.len) != 0;
+
+	bench_fill(&vec);
+	start = clock();
+	bench_vec_radixsort(tmp, &vec);
+	bench_print("sort", "radix sort", BENCH_ELEMENTS, bench_time(start));
+	err |= memcmp(vec.at, ref.at, sizeof(unsigned) * vec.len) != 0;
+
+	puts("Searching (random keys, about half of them found):");
+	start = clock();
+	for (num = 0, found = 0; num < BENCH_LOOKUPS; num++) {
+		unsigned key = vec.at[bench_next(&state) % vec.len] +
+			(unsigned)(num & 1);
+		found += bsearch(&key, vec.at, vec.len, sizeof(unsigned),
+			bench_cmp) != NULL;
+	}
+	bench_print("search", "bsearch", BENCH_LOOKUPS, bench_time(start));
+	bench_sink = found;
+
+	state = 2;
+	start = clock();
+	for (num = 0, found = 0; num < BENCH_LOOKUPS; num++) {
+		unsigned key = vec.at[bench_next(&state) % vec.len] +
+			(unsigned)(num & 1);
+		found += bench_vec_search(key, &vec) != NULL;
+	}
+	bench_print("search", "branchless", BENCH_LOOKUPS, bench_time(start));
+	err |= found != bench_sink;
+
+	puts("Removing the repeated elements:");
+	start = clock();
+	bench_vec_unique(&vec);
+	bench_print("unique", "in place", BENCH_ELEMENTS, bench_time(start));
+	for (num = 1; num < vec.len; num++)
+		err |= vec.at[num - 1] >= vec.at[num];
+
+	if (err)
+		puts("wrong results");
+	free(tmp);
+	bench_vec_afini(&ref);
+	bench_vec_afini(&vec);
+	return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
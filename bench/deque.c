@@ -0,0 +1,181 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <bbmacro/static.h>
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__) /* C11. */
+#include <stdatomic.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/atomic.h>
+#include <bbmacro/deque.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Scaling of a task scheduler with the number of threads.
+ * A task `n` splits into the tasks `n - 1` and `n - 2` (the Fibonacci tree).
+ * Per-thread work-stealing deques are compared with a single vector
+ * protected by a mutex. The result of every run is checked.
+ */
+
+/* Root task. */
+#define BENCH_FIB 25
+
+/* Maximum number of threads. */
+#define BENCH_THREADS 8
+
+WSDEQUE_DEFAULT(bench_deque, int);
+BVECTOR_DEFAULT(bench_stack, int);
+
+struct bench_worker {
+	pthread_t id;
+	struct bench_deque deque;
+	unsigned long seed, result;
+};
+
+static struct bench_worker bench_workers[BENCH_THREADS];
+static int bench_threads;
+
+/* Number of tasks pushed but not finished yet. */
+static BBATOMIC(long) bench_pending;
+
+/* Global stack for the baseline. */
+static pthread_mutex_t bench_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct bench_stack bench_global;
+
+/* Wall-clock time in seconds. */
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *bench_stealing(void *arg)
+{
+	struct bench_worker *self = arg;
+	int task;
+
+	while (bbatomic_load(&bench_pending, BBATOMIC_ACQUIRE) > 0) {
+		struct bench_worker *victim;
+		if (bench_deque_pop(&task, &self->deque)) {
+			self->seed = self->seed * 1103515245UL + 12345UL;
+			victim = &bench_workers[(self->seed >> 16) % bench_threads];
+			if (victim == self ||
+				bench_deque_steal(&task, &victim->deque)) {
+				sched_yield();
+				continue;
+			}
+		}
+		if (task < 2) {
+			self->result += task;
+			bbatomic_fetch_sub(&bench_pending, 1, BBATOMIC_RELEASE);
+		} else {
+			bbatomic_fetch_add(&bench_pending, 1, BBATOMIC_RELAXED);
+			bench_deque_apush(task - 1, &self->deque);
+			bench_deque_apush(task - 2, &self->deque);
+		}
+	}
+	return NULL;
+}
+
+static void *bench_locked(void *arg)
+{
+	struct bench_worker *self = arg;
+	int task;
+
+	while (bbatomic_load(&bench_pending, BBATOMIC_ACQUIRE) > 0) {
+		int got = 0;
+		pthread_mutex_lock(&bench_mutex);
+		if (bench_global.len) {
+			task = *bench_stack_back(&bench_global);
+			bench_stack_popback(&bench_global);
+			got = 1;
+		}
+		pthread_mutex_unlock(&bench_mutex);
+		if (!got) {
+			sched_yield();
+			continue;
+		}
+		if (task < 2) {
+			self->result += task;
+			bbatomic_fetch_sub(&bench_pending, 1, BBATOMIC_RELEASE);
+		} else {
+			bbatomic_fetch_add(&bench_pending, 1, BBATOMIC_RELAXED);
+			pthread_mutex_lock(&bench_mutex);
+			bench_stack_apushback(task - 1, &bench_global);
+			bench_stack_apushback(task - 2, &bench_global);
+			pthread_mutex_unlock(&bench_mutex);
+		}
+	}
+	return NULL;
+}
+
+/* Run the tree on the threads; return non-zero if the result is wrong. */
+static int bench_run(const char *kind, void *(*work)(void *),
+	unsigned long expected, unsigned long tasks)
+{
+	unsigned long result = 0;
+	double start, sec;
+	int i;
+
+	for (i = 0; i < bench_threads; i++) {
+		bench_workers[i].seed = i + 1;
+		bench_workers[i].result = 0;
+		bench_deque_ainit(0, &bench_workers[i].deque);
+	}
+	bench_stack_ainit(0, &bench_global);
+	bbatomic_store(&bench_pending, 1, BBATOMIC_RELAXED);
+	bench_deque_apush(BENCH_FIB, &bench_workers[0].deque);
+	bench_stack_apushback(BENCH_FIB, &bench_global);
+
+	start = bench_now();
+	for (i = 0; i < bench_threads; i++)
+		pthread_create(&bench_workers[i].id, NULL, work, &bench_workers[i]);
+	for (i = 0; i < bench_threads; i++)
+		pthread_join(bench_workers[i].id, NULL);
+	sec = bench_now() - start;
+
+	for (i = 0; i < bench_threads; i++) {
+		result += bench_workers[i].result;
+		bench_deque_afini(&bench_workers[i].deque);
+	}
+	bench_stack_afini(&bench_global);
+
+	printf("%-15s %d threads %8.2f ns/task\n", kind, bench_threads,
+		sec * 1e9 / tasks);
+	if (result != expected) {
+		printf("%-15s wrong result %lu (expected %lu)\n", kind,
+			result, expected);
+		return -1;
+	}
+	return 0;
+}
+
+int main(void)
+{
+	unsigned long fib[BENCH_FIB + 2];
+	int i, err = 0;
+
+	fib[0] = 0;
+	fib[1] = 1;
+	for (i = 2; i <= BENCH_FIB + 1; i++)
+		fib[i] = fib[i - 1] + fib[i - 2];
+
+	/* The tree of `n` has fib(n) leaves of 1 and fib(n + 1) * 2 - 1 tasks. */
+	puts("Task scheduling (work-stealing deques vs a locked vector):");
+	for (bench_threads = 1; bench_threads <= BENCH_THREADS;
+		bench_threads *= 2) {
+		err |= bench_run("stealing deque", bench_stealing,
+			fib[BENCH_FIB], fib[BENCH_FIB + 1] * 2 - 1);
+		err |= bench_run("locked vector", bench_locked,
+			fib[BENCH_FIB], fib[BENCH_FIB + 1] * 2 - 1);
+	}
+	return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/hashmap.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Throughput of the hash table lookups.
+ * The keys found and the keys missing are looked up separately.
+ * The binary search over a sorted array is the baseline.
+ */
+
+/* Number of keys in a table. */
+#define BENCH_KEYS ((size_t)1 << 18)
+
+/* Number of lookups in a run. */
+#define BENCH_LOOKUPS ((size_t)1 << 22)
+
+/* Keep the results alive. */
+static volatile size_t bench_sink;
+
+/* Time since the start of the run. */
+static double bench_time(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Print a result line. */
+static void bench_print(const char *op, const char *kind, size_t num,
+	double sec)
+{
+	printf("%-8s %-15s %8.2f ns/op\n", op, kind, sec * 1e9 / num);
+}
+
+/* Pseudo-random sequence. */
+static unsigned long bench_next(unsigned long *state)
+{
+	*state = (*state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+	return *state >> 1;
+}
+
+/* Keys: the even numbers are inserted, the odd numbers are missing. */
+static char bench_str[BENCH_KEYS * 2][16];
+
+static int bench_strcmp(const void *str1, const void *str2)
+{
+	return strcmp(*(char *const *)str1, *(char *const *)str2);
+}
+
+static int bench_ulongcmp(const void *num1, const void *num2)
+{
+	unsigned long ul1 = *(const unsigned long *)num1;
+	unsigned long ul2 = *(const unsigned long *)num2;
+
+	return ul1 < ul2 ? -1 : ul1 > ul2;
+}
+
+#define bench_hash(key) ((size_t)(key))
+#define bench_eq(key1, key2) ((key1) == (key2))
+#define bench_streq(key1, key2) (!strcmp((key1), (key2)))
+
+HASHMAP_DEFAULT(bench_smap, const char *, size_t, bbhash_str, bench_streq);
+HASHMAP_DEFAULT(bench_imap, unsigned long, size_t, bench_hash, bench_eq);
+
+/* Look up the keys found (`odd` is 0) or missing (`odd` is 1). */
+static void bench_string(int odd)
+{
+	const char **sorted = bbmemory_alloc(BENCH_KEYS, sizeof(*sorted));
+	const char *kind = odd ? "miss" : "hit";
+	struct bench_smap map;
+	unsigned long state = 1;
+	clock_t start;
+	size_t i;
+
+	bench_smap_ainit(BENCH_KEYS, &map);
+	for (i = 0; i < BENCH_KEYS; i++) {
+		sorted[i] = bench_str[i * 2];
+		bench_smap_aset(bench_str[i * 2], i, &map);
+	}
+	qsort(sorted, BENCH_KEYS, sizeof(*sorted), bench_strcmp);
+
+	start = clock();
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		size_t num = bench_next(&state) % BENCH_KEYS * 2 + odd;
+		bench_sink += bench_smap_get(bench_str[num], &map) != NULL;
+	}
+	bench_print(kind, "string hashmap", BENCH_LOOKUPS, bench_time(start));
+
+	state = 1;
+	start = clock();
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		size_t num = bench_next(&state) % BENCH_KEYS * 2 + odd;
+		const char *key = bench_str[num];
+		bench_sink += bsearch(&key, sorted, BENCH_KEYS, sizeof(*sorted),
+			bench_strcmp) != NULL;
+	}
+	bench_print(kind, "string bsearch", BENCH_LOOKUPS, bench_time(start));
+
+	bench_smap_afini(&map);
+	free(sorted);
+}
+
+static void bench_integer(int odd)
+{
+	unsigned long *sorted = bbmemory_alloc(BENCH_KEYS, sizeof(*sorted));
+	const char *kind = odd ? "miss" : "hit";
+	struct bench_imap map;
+	unsigned long state = 1;
+	clock_t start;
+	size_t i;
+
+	bench_imap_ainit(BENCH_KEYS, &map);
+	for (i = 0; i < BENCH_KEYS; i++) {
+		sorted[i] = i * 2;
+		bench_imap_aset(i * 2, i, &map);
+	}
+	qsort(sorted, BENCH_KEYS, sizeof(*sorted), bench_ulongcmp);
+
+	start = clock();
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		unsigned long key = bench_next(&state) % BENCH_KEYS * 2 + odd;
+		bench_sink += bench_imap_get(key, &map) != NULL;
+	}
+	bench_print(kind, "integer hashmap", BENCH_LOOKUPS, bench_time(start));
+
+	state = 1;
+	start = clock();
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		unsigned long key = bench_next(&state) % BENCH_KEYS * 2 + odd;
+		bench_sink += bsearch(&key, sorted, BENCH_KEYS, sizeof(*sorted),
+			bench_ulongcmp) != NULL;
+	}
+	bench_print(kind, "integer bsearch", BENCH_LOOKUPS, bench_time(start));
+
+	bench_imap_afini(&map);
+	free(sorted);
+}
+
+int main(void)
+{
+	size_t i;
+
+	for (i = 0; i < BENCH_KEYS * 2; i++)
+		sprintf(bench_str[i], "key%lu", (unsigned long)i);
+#if defined(BBSSE2)
+	puts("Hash table lookups (SSE2 group match):");
+#elif ULONG_MAX > 0xFFFFFFFFUL
+	puts("Hash table lookups (SWAR group match):");
+#else
+	puts("Hash table lookups (scalar group match):");
+#endif
+	bench_string(0);
+	bench_string(1);
+	bench_integer(0);
+	bench_integer(1);
+	return 0;
+}
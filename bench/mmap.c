@@ -0,0 +1,83 @@
+#define _GNU_SOURCE
+#define BBMEMORY_MMAP
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Growth of a large vector by pushing the elements one by one.
+ * The vector allocating a new block and copying (`BVECTOR`), the vector
+ * reallocating with `realloc()` (`BVECTOR_DEFAULT`) and the vector of
+ * memory mappings (`BVECTOR_MMAP_DEFAULT`) are compared.
+ */
+
+/* Number of elements pushed (256 MiB of doubles). */
+#define BENCH_ELEMENTS ((size_t)1 << 25)
+
+BVECTOR(bench_copy, double, bbmemory_alloc, free, bbmemory_increase);
+BVECTOR_DEFAULT(bench_realloc, double);
+BVECTOR_MMAP_DEFAULT(bench_mmap, double);
+
+/* Time since the start of the run. */
+static double bench_time(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Print a result line. */
+static void bench_print(const char *kind, double sec)
+{
+	printf("%-10s %8.2f ns/push %8.1f ms total\n", kind,
+		sec * 1e9 / BENCH_ELEMENTS, sec * 1e3);
+}
+
+int main(void)
+{
+	struct bench_copy copy;
+	struct bench_realloc re;
+	struct bench_mmap map;
+	clock_t start;
+	size_t i;
+	int err = 0;
+
+	puts("Growth of a large vector (copying vs realloc vs mmap):");
+
+	start = clock();
+	bench_copy_ainit(0, &copy);
+	for (i = 0; i < BENCH_ELEMENTS; i++)
+		bench_copy_apushback((double)i, &copy);
+	bench_print("copying", bench_time(start));
+	err |= copy.at[BENCH_ELEMENTS - 1] != (double)(BENCH_ELEMENTS - 1);
+	bench_copy_afini(&copy);
+
+	start = clock();
+	bench_realloc_ainit(0, &re);
+	for (i = 0; i < BENCH_ELEMENTS; i++)
+		bench_realloc_apushback((double)i, &re);
+	bench_print("realloc", bench_time(start));
+	err |= re.at[BENCH_ELEMENTS - 1] != (double)(BENCH_ELEMENTS - 1);
+	bench_realloc_afini(&re);
+
+	start = clock();
+	bench_mmap_ainit(0, &map);
+	for (i = 0; i < BENCH_ELEMENTS; i++)
+		bench_mmap_apushback((double)i, &map);
+	bench_print("mmap", bench_time(start));
+	err |= map.at[BENCH_ELEMENTS - 1] != (double)(BENCH_ELEMENTS - 1);
+	bench_mmap_afini(&map);
+
+	if (err)
+		puts("wrong contents");
+	return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/algo.h>
+#include <bbmacro/parallel.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Scaling of the parallel sort and for-each with the number of threads.
+ * The speedup is relative to the run with one thread.
+ */
+
+/* Number of elements. */
+#define BENCH_ELEMENTS ((size_t)1 << 23)
+
+/* Maximum number of threads. */
+#define BENCH_THREADS 8
+
+#define bench_less(num1, num2) ((num1) < (num2))
+
+BVECTOR_DEFAULT(bench_vec, double);
+BVECTOR_ALGO(bench_vec, double, bench_less);
+BVECTOR_PARALLEL(bench_vec, double, bench_less);
+
+/* Wall-clock time in seconds. */
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Fill the vector with the same random numbers. */
+static void bench_fill(struct bench_vec *vec)
+{
+	unsigned long state = 1;
+	size_t num;
+
+	for (num = 0; num < vec->len; num++) {
+		state = (state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+		vec->at[num] = (double)(state >> 1);
+	}
+}
+
+/* Some arithmetic per element. */
+static void bench_update(double *at, size_t num, void *arg)
+{
+	double scale = *(double *)arg;
+	size_t pos;
+
+	for (pos = 0; pos < num; pos++)
+		at[pos] = at[pos] * scale + 1.0 / (at[pos] + 1.0);
+}
+
+int main(void)
+{
+	double *tmp = bbmemory_alloc(BENCH_ELEMENTS, sizeof(double));
+	double sort1 = 0, for1 = 0, start, sec, scale = 0.5;
+	struct bbparallel_pool pool;
+	struct bench_vec vec;
+	size_t num;
+	int threads, err = 0;
+
+	bench_vec_ainit(BENCH_ELEMENTS, &vec);
+	bench_vec_resizeback(BENCH_ELEMENTS, &vec);
+
+	puts("Parallel sort and for-each (speedup over one thread):");
+	for (threads = 1; threads <= BENCH_THREADS; threads *= 2) {
+		bbparallel_init(threads, &pool);
+
+		bench_fill(&vec);
+		start = bench_now();
+		bench_vec_psort(tmp, &pool, &vec);
+		sec = bench_now() - start;
+		if (threads == 1)
+			sort1 = sec;
+		printf("psort %d threads %8.2f ns/element %6.2fx\n", threads,
+			sec * 1e9 / vec.len, sort1 / sec);
+		for (num = 1; num < vec.len; num++)
+			err |= vec.at[num] < vec.at[num - 1];
+
+		start = bench_now();
+		bench_vec_pfor(bench_update, &scale, &pool, &vec);
+		sec = bench_now() - start;
+		if (threads == 1)
+			for1 = sec;
+		printf("pfor  %d threads %8.2f ns/element %6.2fx\n", threads,
+			sec * 1e9 / vec.len, for1 / sec);
+
+		bbparallel_fini(&pool);
+	}
+
+	if (err)
+		puts("not sorted");
+	free(tmp);
+	bench_vec_afini(&vec);
+	return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/persist.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Startup of a service with a large lookup table: the table is read from
+ * a file into memory, or mapped from the file and only a few lookups are
+ * done. The file is written into the `build` directory.
+ */
+
+/* Number of elements (256 MiB). */
+#define BENCH_ELEMENTS ((size_t)1 << 24)
+
+/* Number of lookups after the start. */
+#define BENCH_LOOKUPS 1000
+
+/* File of the table. */
+#define BENCH_PATH "build/bench/persist.bin"
+
+struct bench_entry {
+	unsigned long key;
+	double value;
+};
+
+BVECTOR_DEFAULT(bench_table, struct bench_entry);
+BVECTOR_PERSIST(bench_table, struct bench_entry);
+
+/* Wall-clock time in seconds. */
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Look up some entries; return non-zero if one is wrong. */
+static int bench_lookup(struct bench_table *table)
+{
+	unsigned long state = 1;
+	int err = 0, num;
+
+	for (num = 0; num < BENCH_LOOKUPS; num++) {
+		size_t pos;
+		state = (state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+		pos = (state >> 1) % table->len;
+		err |= table->at[pos].key != pos;
+	}
+	return err;
+}
+
+int main(void)
+{
+	struct bench_table table;
+	struct bench_entry entry;
+	double start;
+	size_t num;
+	FILE *file;
+	int err = 0;
+
+	bench_table_ainit(BENCH_ELEMENTS, &table);
+	for (num = 0; num < BENCH_ELEMENTS; num++) {
+		entry.key = num;
+		entry.value = num * 0.5;
+		bench_table_pushback(entry, &table);
+	}
+	start = bench_now();
+	if (bench_table_save(BENCH_PATH, &table)) {
+		puts("cannot save " BENCH_PATH);
+		return EXIT_FAILURE;
+	}
+	printf("Table of %lu MiB saved in %.1f ms.\n",
+		(unsigned long)(sizeof(entry) * BENCH_ELEMENTS >> 20),
+		(bench_now() - start) * 1e3);
+	bench_table_afini(&table);
+
+	puts("Startup and some lookups (reading vs mapping):");
+	start = bench_now();
+	bench_table_ainit(BENCH_ELEMENTS, &table);
+	file = fopen(BENCH_PATH, "rb");
+	if (!file || fseek(file, BBPERSIST_HEADER, SEEK_SET) ||
+		fread(table.at, sizeof(entry), BENCH_ELEMENTS, file) !=
+		BENCH_ELEMENTS)
+		err = 1;
+	if (file)
+		fclose(file);
+	table.len = BENCH_ELEMENTS;
+	err |= bench_lookup(&table);
+	printf("%-8s %10.3f ms\n", "read", (bench_now() - start) * 1e3);
+	bench_table_afini(&table);
+
+	start = bench_now();
+	if (bench_table_mmapload(BENCH_PATH, &table))
+		return EXIT_FAILURE;
+	err |= bench_lookup(&table);
+	printf("%-8s %10.3f ms\n", "mmap", (bench_now() - start) * 1e3);
+
+	start = bench_now();
+	err |= bench_table_verify(&table) != 0;
+	printf("%-8s %10.3f ms\n", "verify", (bench_now() - start) * 1e3);
+	bench_table_munload(&table);
+
+	remove(BENCH_PATH);
+	if (err)
+		puts("wrong contents");
+	return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
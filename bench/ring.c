@@ -0,0 +1,244 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <bbmacro/static.h>
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__) /* C11. */
+#include <stdatomic.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/atomic.h>
+#include <bbmacro/ring.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Throughput of the rings with several producer and consumer threads.
+ * Every run is also a stress test: each value pushed must be popped
+ * exactly once, which is checked by the count and the sum of the values.
+ * A queue vector protected by a mutex is the baseline.
+ */
+
+/* Number of values passed in a run. */
+#define BENCH_VALUES ((unsigned long)1 << 20)
+
+/* Capacity of a ring. */
+#define BENCH_CAP 1024
+
+/* Maximum number of threads on a side. */
+#define BENCH_THREADS 8
+
+/* Value telling a consumer to stop (never pushed otherwise). */
+#define BENCH_STOP 0UL
+
+SPSCRING_DEFAULT(bench_spsc, unsigned long);
+MPMCRING_DEFAULT(bench_mpmc, unsigned long);
+QVECTOR_DEFAULT(bench_qv, unsigned long);
+
+/* Queue under test. */
+struct bench_queue {
+	const char *kind;
+	int (*push)(unsigned long value, void *queue);
+	int (*pop)(unsigned long *value, void *queue);
+	void *queue;
+};
+
+static int bench_spsc_push_(unsigned long value, void *queue)
+{
+	return bench_spsc_push(value, queue);
+}
+
+static int bench_spsc_pop_(unsigned long *value, void *queue)
+{
+	return bench_spsc_pop(value, queue);
+}
+
+static int bench_mpmc_push_(unsigned long value, void *queue)
+{
+	return bench_mpmc_push(value, queue);
+}
+
+static int bench_mpmc_pop_(unsigned long *value, void *queue)
+{
+	return bench_mpmc_pop(value, queue);
+}
+
+/* Queue vector protected by a mutex. */
+struct bench_locked {
+	pthread_mutex_t mutex;
+	struct bench_qv qv;
+};
+
+static int bench_locked_push(unsigned long value, void *queue)
+{
+	struct bench_locked *locked = queue;
+	int ret = -1;
+
+	pthread_mutex_lock(&locked->mutex);
+	if (!bench_qv_full(&locked->qv)) {
+		bench_qv_pushback(value, &locked->qv);
+		ret = 0;
+	}
+	pthread_mutex_unlock(&locked->mutex);
+	return ret;
+}
+
+static int bench_locked_pop(unsigned long *value, void *queue)
+{
+	struct bench_locked *locked = queue;
+	int ret = -1;
+
+	pthread_mutex_lock(&locked->mutex);
+	if (locked->qv.len) {
+		*value = *bench_qv_front(&locked->qv);
+		bench_qv_popfront(&locked->qv);
+		ret = 0;
+	}
+	pthread_mutex_unlock(&locked->mutex);
+	return ret;
+}
+
+/* Work of a thread. */
+struct bench_thread {
+	pthread_t id;
+	struct bench_queue *queue;
+	unsigned long first, num; /* Values to push (producer). */
+	unsigned long count, sum; /* Values popped (consumer). */
+};
+
+static void *bench_producer(void *arg)
+{
+	struct bench_thread *thread = arg;
+	unsigned long value, end = thread->first + thread->num;
+
+	for (value = thread->first; value < end; value++)
+		while (thread->queue->push(value, thread->queue->queue))
+			sched_yield();
+	return NULL;
+}
+
+static void *bench_consumer(void *arg)
+{
+	struct bench_thread *thread = arg;
+	unsigned long value;
+
+	for (;;) {
+		if (thread->queue->pop(&value, thread->queue->queue)) {
+			sched_yield();
+			continue;
+		}
+		if (value == BENCH_STOP)
+			break;
+		thread->count++;
+		thread->sum += value;
+	}
+	return NULL;
+}
+
+/* Wall-clock time in seconds. */
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Run producers and consumers; return non-zero if a value is lost. */
+static int bench_run(struct bench_queue *queue, int producers, int consumers)
+{
+	struct bench_thread prod[BENCH_THREADS], cons[BENCH_THREADS];
+	unsigned long per = BENCH_VALUES / producers, count = 0, sum = 0;
+	unsigned long total = per * producers;
+	double start = bench_now(), sec;
+	int i;
+
+	memset(prod, 0, sizeof(prod));
+	memset(cons, 0, sizeof(cons));
+	for (i = 0; i < consumers; i++) {
+		cons[i].queue = queue;
+		pthread_create(&cons[i].id, NULL, bench_consumer, &cons[i]);
+	}
+	for (i = 0; i < producers; i++) {
+		prod[i].queue = queue;
+		prod[i].first = 1 + per * i;
+		prod[i].num = per;
+		pthread_create(&prod[i].id, NULL, bench_producer, &prod[i]);
+	}
+	for (i = 0; i < producers; i++)
+		pthread_join(prod[i].id, NULL);
+	for (i = 0; i < consumers; i++)
+		while (queue->push(BENCH_STOP, queue->queue))
+			sched_yield();
+	for (i = 0; i < consumers; i++) {
+		pthread_join(cons[i].id, NULL);
+		count += cons[i].count;
+		sum += cons[i].sum;
+	}
+	sec = bench_now() - start;
+
+	printf("%-15s %d x %d %8.2f ns/op %8.2f Mop/s\n", queue->kind,
+		producers, consumers, sec * 1e9 / total, total / sec * 1e-6);
+	if (count != total || sum != total / 2 * (total + 1)) {
+		printf("%-15s lost values: %lu of %lu popped\n", queue->kind,
+			count, total);
+		return -1;
+	}
+	return 0;
+}
+
+int main(void)
+{
+	static const int sides[][2] = { {1, 1}, {2, 2}, {4, 4}, {1, 4}, {4, 1} };
+	static const char *small[] = { "MPMC ring (1)", "MPMC ring (2)" };
+	struct bench_spsc spsc;
+	struct bench_mpmc mpmc;
+	struct bench_locked locked;
+	struct bench_queue queue;
+	size_t i;
+	int err = 0;
+
+	puts("Ring throughput (producers x consumers):");
+
+	bench_spsc_ainit(BENCH_CAP, &spsc);
+	queue.kind = "SPSC ring";
+	queue.push = bench_spsc_push_;
+	queue.pop = bench_spsc_pop_;
+	queue.queue = &spsc;
+	err |= bench_run(&queue, 1, 1);
+	bench_spsc_afini(&spsc);
+
+	bench_mpmc_ainit(BENCH_CAP, &mpmc);
+	queue.kind = "MPMC ring";
+	queue.push = bench_mpmc_push_;
+	queue.pop = bench_mpmc_pop_;
+	queue.queue = &mpmc;
+	for (i = 0; i < bbstatic_len(sides); i++)
+		err |= bench_run(&queue, sides[i][0], sides[i][1]);
+	bench_mpmc_afini(&mpmc);
+
+	/* The smallest capacities (a capacity of 1 is raised to 2). */
+	for (i = 0; i < bbstatic_len(small); i++) {
+		bench_mpmc_ainit(i + 1, &mpmc);
+		queue.kind = small[i];
+		err |= bench_run(&queue, 2, 2);
+		bench_mpmc_afini(&mpmc);
+	}
+
+	pthread_mutex_init(&locked.mutex, NULL);
+	bench_qv_ainit(BENCH_CAP, &locked.qv);
+	queue.kind = "mutex vector";
+	queue.push = bench_locked_push;
+	queue.pop = bench_locked_pop;
+	queue.queue = &locked;
+	for (i = 0; i < bbstatic_len(sides); i++)
+		err |= bench_run(&queue, sides[i][0], sides[i][1]);
+	bench_qv_afini(&locked.qv);
+	pthread_mutex_destroy(&locked.mutex);
+
+	return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/soa.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Throughput of a scan over one field of many records.
+ * A vector of structures is compared with a structure of arrays,
+ * where the scanned field is a contiguous column.
+ */
+
+/* Number of records. */
+#define BENCH_RECORDS ((size_t)1 << 20)
+
+/* Number of scans in a run. */
+#define BENCH_SCANS 32
+
+#define BENCH_FIELDS(FIELD) \
+	FIELD(float, x) FIELD(float, y) FIELD(float, z) \
+	FIELD(float, vx) FIELD(float, vy) FIELD(float, vz) \
+	FIELD(double, mass) FIELD(long, id)
+
+SOA_DEFAULT(bench_soa, BENCH_FIELDS);
+BVECTOR_DEFAULT(bench_aos, struct bench_soa_row);
+
+/* Keep the results alive. */
+static volatile double bench_sink;
+
+/* Time since the start of the run. */
+static double bench_time(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Print a result line. */
+static void bench_print(const char *kind, double sec)
+{
+	printf("%-20s %8.3f ns/record\n", kind,
+		sec * 1e9 / BENCH_RECORDS / BENCH_SCANS);
+}
+
+int main(void)
+{
+	struct bench_soa soa;
+	struct bench_aos aos;
+	struct bench_soa_row row;
+	clock_t start;
+	double sum;
+	size_t i, scan;
+
+	bench_soa_ainit(0, &soa);
+	bench_aos_ainit(0, &aos);
+	memset(&row, 0, sizeof(row));
+	for (i = 0; i < BENCH_RECORDS; i++) {
+		row.x = (float)(i & 0xFF);
+		row.mass = (double)(i & 0xF);
+		row.id = (long)i;
+		bench_soa_apushback(row, &soa);
+		bench_aos_apushback(row, &aos);
+	}
+
+	puts("Scan over one field (vector of structures vs structure of arrays):");
+	start = clock();
+	for (scan = 0, sum = 0; scan < BENCH_SCANS; scan++)
+		for (i = 0; i < aos.len; i++)
+			sum += aos.at[i].mass;
+	bench_print("vector of structures", bench_time(start));
+	bench_sink = sum;
+
+	start = clock();
+	for (scan = 0, sum = 0; scan < BENCH_SCANS; scan++)
+		for (i = 0; i < soa.len; i++)
+			sum += soa.mass[i];
+	bench_print("structure of arrays", bench_time(start));
+	if (sum != bench_sink) {
+		puts("different sums");
+		return EXIT_FAILURE;
+	}
+
+	bench_aos_afini(&aos);
+	bench_soa_afini(&soa);
+	return EXIT_SUCCESS;
+}
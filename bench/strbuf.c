@@ -0,0 +1,87 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/hashmap.h>
+#include <bbmacro/pqueue.h>
+#include <bbmacro/soa.h>
+#include <bbmacro/memory.h>
+#include <bbmacro/strbuf.h>
+
+/*
+ * Building a log of many lines of a few fields each.
+ * Formatting every line with `snprintf()` into a temporary buffer is
+ * compared with the formatted and the plain appends of the builder.
+ */
+
+/* Number of lines. */
+#define BENCH_LINES 1000000
+
+/* Time since the start of the run. */
+static double bench_time(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Print a result line. */
+static void bench_print(const char *kind, double sec, struct bbstrbuf *sb)
+{
+	printf("%-10s %8.2f ns/line %10lu bytes\n", kind,
+		sec * 1e9 / BENCH_LINES, (unsigned long)sb->len);
+}
+
+int main(void)
+{
+	struct bbstrbuf sb, ref;
+	clock_t start;
+	char line[128];
+	long num;
+	int err;
+
+	bbstrbuf_ainit(0, &ref);
+	start = clock();
+	for (num = 0; num < BENCH_LINES; num++) {
+		int len = snprintf(line, sizeof(line),
+			"request %ld status %ld bytes %ld\n",
+			num, num % 600 - 100, num * 37);
+		bbstrbuf_append(line, (size_t)len, &ref);
+	}
+	bench_print("snprintf", bench_time(start), &ref);
+
+	bbstrbuf_ainit(0, &sb);
+	start = clock();
+	for (num = 0; num < BENCH_LINES; num++)
+		bbstrbuf_appendf(&sb, "request %ld status %ld bytes %ld\n",
+			num, num % 600 - 100, num * 37);
+	bench_print("appendf", bench_time(start), &sb);
+	err = sb.len != ref.len || memcmp(sb.at, ref.at, sb.len);
+
+	bbstrbuf_clear(&sb);
+	start = clock();
+	for (num = 0; num < BENCH_LINES; num++) {
+		bbstrbuf_append("request ", 8, &sb);
+		bbstrbuf_appendl(num, &sb);
+		bbstrbuf_append(" status ", 8, &sb);
+		bbstrbuf_appendl(num % 600 - 100, &sb);
+		bbstrbuf_append(" bytes ", 7, &sb);
+		bbstrbuf_appendl(num * 37, &sb);
+		bbstrbuf_appendc('\n', &sb);
+	}
+	bench_print("appendl", bench_time(start), &sb);
+	err |= sb.len != ref.len || memcmp(sb.at, ref.at, sb.len);
+
+	if (err)
+		puts("wrong contents");
+	bbstrbuf_afini(&sb);
+	bbstrbuf_afini(&ref);
+	return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/stream.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Throughput of passing a vector through a pipe to another thread.
+ * The chunked writer is compared with writing the elements one by one;
+ * the reader decodes the stream incrementally (`sfeed`) in both cases.
+ */
+
+/* Number of elements (16 MiB of doubles). */
+#define BENCH_ELEMENTS ((size_t)1 << 21)
+
+/* Size of a buffer of the reader. */
+#define BENCH_BUF 65536
+
+BVECTOR_DEFAULT(bench_vec, double);
+BVECTOR_STREAM(bench_vec, double);
+
+/* Writer thread. */
+struct bench_writer {
+	pthread_t id;
+	int fd, chunked, err;
+	struct bench_vec *vec;
+};
+
+/* Wall-clock time in seconds. */
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Write the frames of one element each (the baseline). */
+static int bench_write_each(int fd, struct bench_vec *vec)
+{
+	unsigned char head[4];
+	struct iovec iov[2];
+	size_t num;
+
+	for (num = 0; num < vec->len; num++) {
+		bbstream_put(head, 1);
+		iov[0].iov_base = head;
+		iov[0].iov_len = 4;
+		iov[1].iov_base = &vec->at[num];
+		iov[1].iov_len = sizeof(double);
+		if (bbstream_writev(fd, iov, 2))
+			return -1;
+	}
+	bbstream_put(head, 0);
+	iov[0].iov_base = head;
+	iov[0].iov_len = 4;
+	return bbstream_writev(fd, iov, 1);
+}
+
+static void *bench_writer(void *arg)
+{
+	struct bench_writer *writer = arg;
+
+	writer->err = writer->chunked ?
+		bench_vec_swrite(writer->fd, writer->vec) :
+		bench_write_each(writer->fd, writer->vec);
+	close(writer->fd);
+	return NULL;
+}
+
+/* Pass the vector; return non-zero if it differs on the other side. */
+static int bench_run(const char *kind, int chunked, struct bench_vec *src)
+{
+	static char buf[BENCH_BUF];
+	struct bench_writer writer;
+	struct bench_vec dst;
+	struct bbstream st;
+	double start = bench_now(), sec;
+	int fds[2], res = 0;
+	ssize_t len;
+
+	if (pipe(fds))
+		return -1;
+	writer.fd = fds[1];
+	writer.chunked = chunked;
+	writer.vec = src;
+	pthread_create(&writer.id, NULL, bench_writer, &writer);
+
+	bench_vec_ainit(0, &dst);
+	bbstream_init(&st);
+	while (res == 0 && (len = read(fds[0], buf, sizeof(buf))) != 0) {
+		if (len < 0 && errno == EINTR)
+			continue;
+		if (len < 0)
+			break;
+		res = bench_vec_sfeed(buf, (size_t)len, &st, &dst);
+	}
+	pthread_join(writer.id, NULL);
+	close(fds[0]);
+	sec = bench_now() - start;
+
+	printf("%-15s %8.2f ns/element %8.1f MiB/s\n", kind,
+		sec * 1e9 / src->len, sizeof(double) * src->len / sec / (1 << 20));
+	res = res != 1 || writer.err || dst.len != src->len ||
+		memcmp(dst.at, src->at, sizeof(double) * src->len);
+	bench_vec_afini(&dst);
+	return res;
+}
+
+int main(void)
+{
+	struct bench_vec vec;
+	size_t num;
+	int err = 0;
+
+	bench_vec_ainit(BENCH_ELEMENTS, &vec);
+	for (num = 0; num < BENCH_ELEMENTS; num++)
+		bench_vec_pushback(num * 0.5, &vec);
+
+	puts("Streaming a vector through a pipe:");
+	err |= bench_run("chunked", 1, &vec);
+	err |= bench_run("element-wise", 0, &vec);
+
+	if (err)
+		puts("wrong contents");
+	bench_vec_afini(&vec);
+	return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <bbmacro/static.h>
+#include <bbmacro/vector.h>
+#include <bbmacro/memory.h>
+
+/*
+ * Throughput of the vector operations.
+ * Every operation is run for several element sizes and growth factors.
+ * The plain `realloc()` loop is the baseline. The copied bytes are counted
+ * in a separate untimed run by watching the memory move.
+ */
+
+/* Total size of the elements pushed in a run. */
+#define BENCH_BYTES ((size_t)1 << 24)
+
+/* Keep the results alive. */
+static volatile size_t bench_sink;
+
+/* Alternative growth factor. */
+static size_t bench_double(size_t cap)
+{
+	return cap < 4 ? 4 : cap * 2;
+}
+
+/* Time since the start of the run. */
+static double bench_time(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Print a result line. */
+static void bench_print(const char *op, const char *kind, size_t size,
+	size_t num, double sec, size_t copied)
+{
+	printf("%-8s %-15s %3lu B %8.2f ns/op %12lu B copied\n",
+		op, kind, (unsigned long)size, sec * 1e9 / num,
+		(unsigned long)copied);
+}
+
+/* Element types of the given sizes. */
+struct bench_16 { char at[16]; };
+struct bench_64 { char at[64]; };
+
+/* Benchmarks for a vector type (V is named after its kind). */
+#define BENCH_PUSH(V, ELEMENT, KIND) \
+static void V##_bench_push(void) \
+{	size_t num = BENCH_BYTES / sizeof(ELEMENT), i, copied = 0; \
+	ELEMENT value; \
+	struct V v; \
+	clock_t start; \
+	double sec; \
+	memset(&value, 0, sizeof(value)); \
+	start = clock(); \
+	V##_ainit(0, &v); \
+	for (i = 0; i < num; i++) \
+		V##_apushback(value, &v); \
+	bench_sink += v.len; \
+	V##_afini(&v); \
+	sec = bench_time(start); \
+	V##_ainit(0, &v); \
+	for (i = 0; i < num; i++) { \
+		ELEMENT *old = v.at; \
+		V##_apushback(value, &v); \
+		if (v.at != old) \
+			copied += (v.len - 1) * sizeof(ELEMENT); \
+	} \
+	V##_afini(&v); \
+	bench_print("push", KIND, sizeof(ELEMENT), num, sec, copied); \
+} \
+static void V##_bench_grow(void) \
+{	size_t num = BENCH_BYTES / sizeof(ELEMENT), i; \
+	struct V v; \
+	clock_t start = clock(); \
+	V##_ainit(0, &v); \
+	for (i = 0; i < num; i += 16) \
+		memset(V##_agrowback(16, &v), 0, sizeof(ELEMENT) * 16); \
+	bench_sink += v.len; \
+	V##_afini(&v); \
+	bench_print("grow16", KIND, sizeof(ELEMENT), num, \
+		bench_time(start), 0); \
+} \
+static void V##_bench_pop(void) \
+{	size_t num = BENCH_BYTES / sizeof(ELEMENT), i; \
+	struct V v; \
+	clock_t start; \
+	V##_ainit(num, &v); \
+	memset(V##_agrowback(num, &v), 0, sizeof(ELEMENT) * num); \
+	start = clock(); \
+	for (i = 0; i < num; i++) { \
+		bench_sink += *(char *)V##_back(&v); \
+		V##_popback(&v); \
+	} \
+	bench_print("pop", KIND, sizeof(ELEMENT), num, bench_time(start), 0); \
+	V##_afini(&v); \
+} \
+static void V##_bench_reserve(void) \
+{	size_t num = BENCH_BYTES / sizeof(ELEMENT); \
+	ELEMENT *old; \
+	struct V v; \
+	clock_t start; \
+	V##_ainit(num, &v); \
+	memset(V##_agrowback(num, &v), 0, sizeof(ELEMENT) * num); \
+	old = v.at; \
+	start = clock(); \
+	V##_areserveback(num * 2, &v); \
+	bench_print("reserve", KIND, sizeof(ELEMENT), num, bench_time(start), \
+		v.at != old ? num * sizeof(ELEMENT) : 0); \
+	V##_afini(&v); \
+} \
+static void V##_bench(void) \
+{	V##_bench_push(); \
+	V##_bench_grow(); \
+	V##_bench_pop(); \
+	V##_bench_reserve(); \
+} \
+bbstatic_semicolon
+
+/* Forward Vector push benchmark. */
+#define BENCH_PUSHFRONT(V, ELEMENT, KIND) \
+static void V##_bench(void) \
+{	size_t num = BENCH_BYTES / sizeof(ELEMENT), i, copied = 0; \
+	ELEMENT value; \
+	struct V v; \
+	clock_t start; \
+	double sec; \
+	memset(&value, 0, sizeof(value)); \
+	start = clock(); \
+	V##_ainit(0, &v); \
+	for (i = 0; i < num; i++) \
+		V##_apushfront(value, &v); \
+	bench_sink += v.len; \
+	V##_afini(&v); \
+	sec = bench_time(start); \
+	V##_ainit(0, &v); \
+	for (i = 0; i < num; i++) { \
+		ELEMENT *old = v.neg; \
+		V##_apushfront(value, &v); \
+		if (v.neg != old) \
+			copied += (v.len - 1) * sizeof(ELEMENT); \
+	} \
+	V##_afini(&v); \
+	bench_print("push", KIND, sizeof(ELEMENT), num, sec, copied); \
+} \
+bbstatic_semicolon
+
+/* Plain `realloc()` baseline. */
+#define BENCH_BASELINE(NAME, ELEMENT) \
+static void NAME##_bench(void) \
+{	size_t num = BENCH_BYTES / sizeof(ELEMENT), i, len = 0, cap = 0; \
+	size_t copied = 0; \
+	ELEMENT value, *at = NULL; \
+	clock_t start; \
+	double sec; \
+	memset(&value, 0, sizeof(value)); \
+	start = clock(); \
+	for (i = 0; i < num; i++) { \
+		if (len == cap) { \
+			cap = bench_double(cap); \
+			at = bbmemory_realloc(at, cap, sizeof(ELEMENT)); \
+		} \
+		at[len++] = value; \
+	} \
+	bench_sink += len; \
+	free(at); \
+	sec = bench_time(start); \
+	at = NULL; \
+	len = cap = 0; \
+	for (i = 0; i < num; i++) { \
+		if (len == cap) { \
+			ELEMENT *old = at; \
+			cap = bench_double(cap); \
+			at = bbmemory_realloc(at, cap, sizeof(ELEMENT)); \
+			if (at != old) \
+				copied += len * sizeof(ELEMENT); \
+		} \
+		at[len++] = value; \
+	} \
+	free(at); \
+	bench_print("push", "plain realloc",  sizeof(ELEMENT), num, sec, copied); \
+} \
+bbstatic_semicolon
+
+/* Instantiate everything for an element type. */
+#define BENCH_TYPE(NAME, ELEMENT) \
+BVECTOR(NAME##_a15, ELEMENT, bbmemory_alloc, free, bbmemory_increase); \
+BVECTOR(NAME##_a2, ELEMENT, bbmemory_alloc, free, bench_double); \
+BVECTOR_REALLOC(NAME##_r15, ELEMENT, \
+	bbmemory_realloc, free, bbmemory_increase); \
+BVECTOR_REALLOC(NAME##_r2, ELEMENT, bbmemory_realloc, free, bench_double); \
+FVECTOR(NAME##_f15, ELEMENT, bbmemory_alloc, free, bbmemory_increase); \
+BENCH_PUSH(NAME##_a15, ELEMENT, "B alloc x1.5"); \
+BENCH_PUSH(NAME##_a2, ELEMENT, "B alloc x2"); \
+BENCH_PUSH(NAME##_r15, ELEMENT, "B realloc x1.5"); \
+BENCH_PUSH(NAME##_r2, ELEMENT, "B realloc x2"); \
+BENCH_PUSHFRONT(NAME##_f15, ELEMENT, "F alloc x1.5"); \
+BENCH_BASELINE(NAME##_base, ELEMENT); \
+static void NAME##_bench(void) \
+{	NAME##_base_bench(); \
+	NAME##_a15_bench(); \
+	NAME##_a2_bench(); \
+	NAME##_r15_bench(); \
+	NAME##_r2_bench(); \
+	NAME##_f15_bench(); \
+} \
+bbstatic_semicolon
+
+BENCH_TYPE(int4, int);
+BENCH_TYPE(blk16, struct bench_16);
+BENCH_TYPE(blk64, struct bench_64);
+
+int main(void)
+{
+	puts("Vector operations:");
+	int4_bench();
+	blk16_bench();
+	blk64_bench();
+	return 0;
+}
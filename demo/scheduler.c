@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <sched.h>
+#include <pthread.h>
+#include <bbmacro/static.h>
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__) /* C11. */
+#include <stdatomic.h>
+#endif
+#include <bbmacro/vector.h>
+#include <bbmacro/atomic.h>
+#include <bbmacro/deque.h>
+#include <bbmacro/memory.h>
+
+/*
+ * A tiny task scheduler: every worker thread owns a deque of tasks,
+ * runs its own tasks newest first and steals the oldest tasks of the
+ * others when it runs out. A task `n` computes the Fibonacci number
+ * by splitting into the tasks `n - 1` and `n - 2`.
+ */
+
+#define WORKERS 4
+#define FIB 27
+
+WSDEQUE_DEFAULT(tasks, int);
+
+struct worker {
+	pthread_t id;
+	struct tasks deque;
+	unsigned long seed; /* For choosing a victim. */
+	unsigned long result, runs, steals;
+};
+
+static struct worker workers[WORKERS];
+
+/* Number of tasks pushed but not finished yet. */
+static BBATOMIC(long) pending;
+
+static void run(int n, struct worker *self)
+{
+	self->runs++;
+	if (n < 2) {
+		self->result += n;
+		bbatomic_fetch_sub(&pending, 1, BBATOMIC_RELEASE);
+		return;
+	}
+	/* Two tasks are pushed in place of this one. */
+	bbatomic_fetch_add(&pending, 1, BBATOMIC_RELAXED);
+	tasks_apush(n - 1, &self->deque);
+	tasks_apush(n - 2, &self->deque);
+}
+
+static void *work(void *arg)
+{
+	struct worker *self = arg;
+	int task;
+
+	while (bbatomic_load(&pending, BBATOMIC_ACQUIRE) > 0) {
+		struct worker *victim;
+		if (!tasks_pop(&task, &self->deque)) {
+			run(task, self);
+			continue;
+		}
+		self->seed = self->seed * 1103515245UL + 12345UL;
+		victim = &workers[(self->seed >> 16) % WORKERS];
+		if (victim != self && !tasks_steal(&task, &victim->deque)) {
+			self->steals++;
+			run(task, self);
+			continue;
+		}
+		sched_yield();
+	}
+	return NULL;
+}
+
+int main(void)
+{
+	unsigned long result = 0, fib[FIB + 1];
+	int i;
+
+	fib[0] = 0;
+	fib[1] = 1;
+	for (i = 2; i <= FIB; i++)
+		fib[i] = fib[i - 1] + fib[i - 2];
+
+	for (i = 0; i < WORKERS; i++) {
+		tasks_ainit(0, &workers[i].deque);
+		workers[i].seed = i + 1;
+	}
+	bbatomic_store(&pending, 1, BBATOMIC_RELAXED);
+	tasks_apush(FIB, &workers[0].deque);
+
+	for (i = 0; i < WORKERS; i++)
+		pthread_create(&workers[i].id, NULL, work, &workers[i]);
+	for (i = 0; i < WORKERS; i++)
+		pthread_join(workers[i].id, NULL);
+
+	for (i = 0; i < WORKERS; i++) {
+		printf("worker %d: %8lu tasks run, %6lu stolen\n",
+			i, workers[i].runs, workers[i].steals);
+		result += workers[i].result;
+		tasks_afini(&workers[i].deque);
+	}
+	printf("fib(%d) = %lu (expected %lu)\n", FIB, result, fib[FIB]);
+	return result == fib[FIB] ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,48 @@
+#define BBMEMORY_STATS
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <bbmacro/ansicolor.h>
+#include <bbmacro/static.h>
+#include <bbmacro/vector.h>
+#include <bbmacro/memory.h>
+
+BVECTOR(numbers, int, bbmemory_alloc, free, bbmemory_increase);
+BVECTOR_DEFAULT(words, const char *);
+FVECTOR_DEFAULT(history, int);
+QVECTOR_DEFAULT(queue, int);
+
+int main(void)
+{
+	struct numbers n;
+	struct words w;
+	struct history h;
+	struct queue q;
+	int i;
+
+	numbers_ainit(0, &n);
+	words_ainit(4, &w);
+	history_ainit(0, &h);
+	queue_ainit(0, &q);
+
+	for (i = 0; i < 100000; i++) {
+		numbers_apushback(i, &n);
+		history_apushfront(i, &h);
+		queue_apushback(i, &q);
+		if (i % 2)
+			queue_popfront(&q);
+	}
+	for (i = 0; i < 1000; i++)
+		words_apushback("word", &w);
+
+	numbers_afini(&n);
+	words_afini(&w);
+	history_afini(&h);
+	/* The queue is deliberately leaked. */
+
+	BBMEMORY_STATS_DUMP(numbers, stdout);
+	BBMEMORY_STATS_DUMP(words, stdout);
+	BBMEMORY_STATS_DUMP(history, stdout);
+	BBMEMORY_STATS_DUMP(queue, stdout);
+	return 0;
+}
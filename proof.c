@@ -1,8 +1,37 @@
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include <bbmacro/static.h>
+#ifdef BBSSE2
+#include <emmintrin.h>
+#endif
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__) /* C11. */
+#include <stdatomic.h>
+#endif
 #include <bbmacro/vector.h>
+#include <bbmacro/hashmap.h>
+#include <bbmacro/pqueue.h>
+#include <bbmacro/algo.h>
+#include <bbmacro/parallel.h>
+#include <bbmacro/persist.h>
+#include <bbmacro/stream.h>
+#include <bbmacro/soa.h>
+#include <bbmacro/atomic.h>
+#include <bbmacro/ring.h>
+#include <bbmacro/deque.h>
+#include <bbmacro/svector.h>
 #include <bbmacro/memory.h>
+#include <bbmacro/strbuf.h>
 
 int a[10], *a_end = bbstatic_end(a);
 bbstatic_assert(10 == bbstatic_len(a));
@@ -23,6 +52,13 @@ FVECTOR_CORE_INTERFACE(fc2, int, extern);
 FVECTOR_CORE_IMPLEMENTATION(fc2, int);
 FVECTOR_CORE(fc1, int);
 
+QVECTOR_STRUCT(qc3, int);
+QVECTOR_CORE_DECLARATIONS(qc3, int, extern);
+QVECTOR_CORE_IMPLEMENTATION(qc3, int);
+QVECTOR_CORE_INTERFACE(qc2, int, extern);
+QVECTOR_CORE_IMPLEMENTATION(qc2, int);
+QVECTOR_CORE(qc1, int);
+
 /* Auto. */
 
 BVECTOR_STRUCT(ba3, int);
@@ -39,6 +75,24 @@ FVECTOR_INTERFACE(fa2, int, extern);
 FVECTOR_IMPLEMENTATION(fa2, int, bbmemory_alloc, free, bbmemory_increase);
 FVECTOR(fa1, int, bbmemory_alloc, free, bbmemory_increase);
 
+QVECTOR_STRUCT(qa3, int);
+QVECTOR_DECLARATIONS(qa3, int, extern);
+QVECTOR_IMPLEMENTATION(qa3, int, bbmemory_alloc, free, bbmemory_increase);
+QVECTOR_INTERFACE(qa2, int, extern);
+QVECTOR_IMPLEMENTATION(qa2, int, bbmemory_alloc, free, bbmemory_increase);
+QVECTOR(qa1, int, bbmemory_alloc, free, bbmemory_increase);
+
+/* Reallocating auto. */
+
+BVECTOR_STRUCT(br3, int);
+BVECTOR_DECLARATIONS(br3, int, extern);
+BVECTOR_REALLOC_IMPLEMENTATION(br3, int,
+	bbmemory_realloc, free, bbmemory_increase);
+BVECTOR_INTERFACE(br2, int, extern);
+BVECTOR_REALLOC_IMPLEMENTATION(br2, int,
+	bbmemory_realloc, free, bbmemory_increase);
+BVECTOR_REALLOC(br1, int, bbmemory_realloc, free, bbmemory_increase);
+
 /* Default auto. */
 
 BVECTOR_STRUCT(bd3, int);
@@ -55,6 +109,267 @@ FVECTOR_INTERFACE(fd2, int, extern);
 FVECTOR_DEFAULT_IMPLEMENTATION(fd2, int);
 FVECTOR_DEFAULT(fd1, int);
 
+QVECTOR_STRUCT(qd3, int);
+QVECTOR_DECLARATIONS(qd3, int, extern);
+QVECTOR_DEFAULT_IMPLEMENTATION(qd3, int);
+QVECTOR_INTERFACE(qd2, int, extern);
+QVECTOR_DEFAULT_IMPLEMENTATION(qd2, int);
+QVECTOR_DEFAULT(qd1, int);
+
+/* Arena auto. */
+
+struct bbmemory_arena arena;
+BBMEMORY_ARENA(proof, &arena);
+
+BVECTOR_INTERFACE(bn2, int, extern);
+BVECTOR_ARENA_IMPLEMENTATION(bn2, int, proof);
+BVECTOR_ARENA(bn1, int, proof);
+
+FVECTOR_INTERFACE(fn2, int, extern);
+FVECTOR_ARENA_IMPLEMENTATION(fn2, int, proof);
+FVECTOR_ARENA(fn1, int, proof);
+
+QVECTOR_INTERFACE(qn2, int, extern);
+QVECTOR_ARENA_IMPLEMENTATION(qn2, int, proof);
+QVECTOR_ARENA(qn1, int, proof);
+
+/* Pool auto. */
+
+BVECTOR_INTERFACE(bp2, int, extern);
+BVECTOR_POOL_IMPLEMENTATION(bp2, int);
+BVECTOR_POOL(bp1, int);
+
+FVECTOR_INTERFACE(fp2, int, extern);
+FVECTOR_POOL_IMPLEMENTATION(fp2, int);
+FVECTOR_POOL(fp1, int);
+
+QVECTOR_INTERFACE(qp2, int, extern);
+QVECTOR_POOL_IMPLEMENTATION(qp2, int);
+QVECTOR_POOL(qp1, int);
+
+/* Aligned auto. */
+
+BBMEMORY_ALIGNED(proof64, 64);
+BVECTOR(bl3, float, proof64_alloc, proof64_free, bbmemory_increase);
+
+BVECTOR_INTERFACE(bl2, float, extern);
+BVECTOR_ALIGNED_DEFAULT_IMPLEMENTATION(bl2, float, 32);
+BVECTOR_ALIGNED_DEFAULT(bl1, float, 64);
+
+/* Memory-mapped auto (check with `-D_GNU_SOURCE -DBBMEMORY_MMAP`). */
+
+#ifdef BBMEMORY_MMAP
+BVECTOR_INTERFACE(bm2, int, extern);
+BVECTOR_MMAP_DEFAULT_IMPLEMENTATION(bm2, int);
+BVECTOR_MMAP_DEFAULT(bm1, int);
+#endif
+
+/* Small auto. */
+
+BVECTOR_SMALL_STRUCT(bs3, int, 8);
+BVECTOR_DECLARATIONS(bs3, int, extern);
+BVECTOR_SMALL_IMPLEMENTATION(bs3, int, 8,
+	bbmemory_alloc, free, bbmemory_increase);
+BVECTOR_SMALL_INTERFACE(bs2, int, 8, extern);
+BVECTOR_SMALL_DEFAULT_IMPLEMENTATION(bs2, int, 8);
+BVECTOR_SMALL(bs1, int, 8, bbmemory_alloc, free, bbmemory_increase);
+BVECTOR_SMALL_DEFAULT(bs0, int, 1);
+
+/* Shrinking auto. */
+
+BVECTOR_SHRINK_DECLARATIONS(ba2, int, extern);
+BVECTOR_SHRINK_IMPLEMENTATION(ba2, int, bbmemory_decrease);
+BVECTOR_SHRINK(ba1, int, bbmemory_decrease);
+BVECTOR_SHRINK_DECLARATIONS(bd2, int, extern);
+BVECTOR_SHRINK_DEFAULT_IMPLEMENTATION(bd2, int);
+BVECTOR_SHRINK_DEFAULT(bd1, int);
+BVECTOR_SHRINK_DEFAULT(bs1, int);
+
+FVECTOR_SHRINK_DECLARATIONS(fa2, int, extern);
+FVECTOR_SHRINK_IMPLEMENTATION(fa2, int, bbmemory_decrease);
+FVECTOR_SHRINK(fa1, int, bbmemory_decrease);
+FVECTOR_SHRINK_DECLARATIONS(fd2, int, extern);
+FVECTOR_SHRINK_DEFAULT_IMPLEMENTATION(fd2, int);
+FVECTOR_SHRINK_DEFAULT(fd1, int);
+
+/* Fallible. */
+
+BVECTOR_TRY_DECLARATIONS(ba2, int, extern);
+BVECTOR_TRY_IMPLEMENTATION(ba2, int,
+	bbmemory_tryalloc, free, bbmemory_tryincrease);
+BVECTOR_TRY(ba1, int, bbmemory_tryalloc, free, bbmemory_tryincrease);
+BVECTOR_TRY_DECLARATIONS(br2, int, extern);
+BVECTOR_TRY_REALLOC_IMPLEMENTATION(br2, int,
+	bbmemory_tryrealloc, bbmemory_tryincrease);
+BVECTOR_TRY_REALLOC(br1, int, bbmemory_tryrealloc, bbmemory_tryincrease);
+BVECTOR_TRY_DECLARATIONS(bd2, int, extern);
+BVECTOR_TRY_DEFAULT_IMPLEMENTATION(bd2, int);
+BVECTOR_TRY_DEFAULT(bd1, int);
+
+FVECTOR_TRY_DECLARATIONS(fa2, int, extern);
+FVECTOR_TRY_IMPLEMENTATION(fa2, int,
+	bbmemory_tryalloc, free, bbmemory_tryincrease);
+FVECTOR_TRY(fa1, int, bbmemory_tryalloc, free, bbmemory_tryincrease);
+FVECTOR_TRY_DECLARATIONS(fd2, int, extern);
+FVECTOR_TRY_DEFAULT_IMPLEMENTATION(fd2, int);
+FVECTOR_TRY_DEFAULT(fd1, int);
+
+/* Priority queue. */
+
+#define proof_less(value1, value2) ((value1) < (value2))
+
+PQUEUE_CORE_DECLARATIONS(bc3, int, extern);
+PQUEUE_CORE_IMPLEMENTATION(bc3, int, proof_less);
+PQUEUE_CORE(bc1, int, proof_less);
+
+PQUEUE_DECLARATIONS(ba3, int, extern);
+PQUEUE_IMPLEMENTATION(ba3, int, proof_less);
+PQUEUE(ba1, int, proof_less);
+
+BVECTOR_INTERFACE(pd2, int, extern);
+PQUEUE_DECLARATIONS(pd2, int, extern);
+PQUEUE_DEFAULT_IMPLEMENTATION(pd2, int, proof_less);
+PQUEUE_DEFAULT(pd1, int, proof_less);
+
+/* Algorithms. */
+
+#define proof_key(value) ((unsigned long)(value))
+
+BVECTOR_ALGO_DECLARATIONS(bc3, int, extern);
+BVECTOR_ALGO_IMPLEMENTATION(bc3, int, proof_less);
+BVECTOR_ALGO(bc1, int, proof_less);
+BVECTOR_RADIX_DECLARATIONS(bc3, int, extern);
+BVECTOR_RADIX_IMPLEMENTATION(bc3, int, proof_key);
+BVECTOR_RADIX(bc1, int, proof_key);
+
+/* Parallel algorithms. */
+
+BVECTOR_PARALLEL_DECLARATIONS(bc3, int, extern);
+BVECTOR_PARALLEL_IMPLEMENTATION(bc3, int, proof_less);
+BVECTOR_PARALLEL(bc1, int, proof_less);
+
+/* Persistence. */
+
+BVECTOR_PERSIST_DECLARATIONS(bc3, int, extern);
+BVECTOR_PERSIST_IMPLEMENTATION(bc3, int);
+BVECTOR_PERSIST(bc1, int);
+
+/* Streaming. */
+
+BVECTOR_STREAM_DECLARATIONS(ba3, int, extern);
+BVECTOR_STREAM_IMPLEMENTATION(ba3, int);
+BVECTOR_STREAM(ba1, int);
+FVECTOR_STREAM_DECLARATIONS(fc3, int, extern);
+FVECTOR_STREAM_IMPLEMENTATION(fc3, int);
+FVECTOR_STREAM(fc1, int);
+
+/* Hash tables. */
+
+#define proof_hash(key) ((size_t)(key))
+#define proof_eq(key1, key2) ((key1) == (key2))
+
+HASHMAP_STRUCT(hc3, int, long);
+HASHMAP_CORE_DECLARATIONS(hc3, int, long, extern);
+HASHMAP_CORE_IMPLEMENTATION(hc3, int, long, proof_hash, proof_eq);
+HASHMAP_CORE_INTERFACE(hc2, int, long, extern);
+HASHMAP_CORE_IMPLEMENTATION(hc2, int, long, proof_hash, proof_eq);
+HASHMAP_CORE(hc1, int, long, proof_hash, proof_eq);
+
+HASHMAP_STRUCT(ha3, int, long);
+HASHMAP_DECLARATIONS(ha3, int, long, extern);
+HASHMAP_IMPLEMENTATION(ha3, int, long, proof_hash, proof_eq,
+	bbmemory_alloc, free);
+HASHMAP_INTERFACE(ha2, int, long, extern);
+HASHMAP_IMPLEMENTATION(ha2, int, long, proof_hash, proof_eq,
+	bbmemory_alloc, free);
+HASHMAP(ha1, int, long, proof_hash, proof_eq, bbmemory_alloc, free);
+
+HASHMAP_INTERFACE(hd2, const char *, int, extern);
+HASHMAP_DEFAULT_IMPLEMENTATION(hd2, const char *, int, bbhash_str, !strcmp);
+HASHMAP_DEFAULT(hd1, const char *, int, bbhash_str, !strcmp);
+
+HASHSET_STRUCT(sc2, int);
+HASHSET_CORE_DECLARATIONS(sc2, int, extern);
+HASHSET_CORE_IMPLEMENTATION(sc2, int, proof_hash, proof_eq);
+HASHSET_CORE(sc1, int, proof_hash, proof_eq);
+
+HASHSET_INTERFACE(sa2, int, extern);
+HASHSET_IMPLEMENTATION(sa2, int, proof_hash, proof_eq, bbmemory_alloc, free);
+HASHSET(sa1, int, proof_hash, proof_eq, bbmemory_alloc, free);
+
+HASHSET_INTERFACE(sd2, const char *, extern);
+HASHSET_DEFAULT_IMPLEMENTATION(sd2, const char *, bbhash_str, !strcmp);
+HASHSET_DEFAULT(sd1, const char *, bbhash_str, !strcmp);
+
+/* Structures of arrays. */
+
+#define PROOF_FIELDS(FIELD) FIELD(int, num) FIELD(double, val) FIELD(char, tag)
+
+SOA_STRUCT(ac3, PROOF_FIELDS);
+SOA_CORE_DECLARATIONS(ac3, PROOF_FIELDS, extern);
+SOA_CORE_IMPLEMENTATION(ac3, PROOF_FIELDS);
+SOA_CORE_INTERFACE(ac2, PROOF_FIELDS, extern);
+SOA_CORE_IMPLEMENTATION(ac2, PROOF_FIELDS);
+SOA_CORE(ac1, PROOF_FIELDS);
+
+SOA_STRUCT(aa3, PROOF_FIELDS);
+SOA_DECLARATIONS(aa3, PROOF_FIELDS, extern);
+SOA_IMPLEMENTATION(aa3, PROOF_FIELDS, bbmemory_alloc, free, bbmemory_increase);
+SOA_INTERFACE(aa2, PROOF_FIELDS, extern);
+SOA_IMPLEMENTATION(aa2, PROOF_FIELDS, bbmemory_alloc, free, bbmemory_increase);
+SOA(aa1, PROOF_FIELDS, bbmemory_alloc, free, bbmemory_increase);
+SOA_DEFAULT(ad1, PROOF_FIELDS);
+
+/* Rings. */
+
+SPSCRING_STRUCT(rc3, int);
+SPSCRING_CORE_DECLARATIONS(rc3, int, extern);
+SPSCRING_CORE_IMPLEMENTATION(rc3, int);
+SPSCRING_CORE_INTERFACE(rc2, int, extern);
+SPSCRING_CORE_IMPLEMENTATION(rc2, int);
+SPSCRING_CORE(rc1, int);
+
+SPSCRING_INTERFACE(ra2, int, extern);
+SPSCRING_IMPLEMENTATION(ra2, int, bbmemory_alloc, free);
+SPSCRING(ra1, int, bbmemory_alloc, free);
+SPSCRING_DEFAULT(rd1, int);
+
+MPMCRING_STRUCT(mc3, int);
+MPMCRING_CORE_DECLARATIONS(mc3, int, extern);
+MPMCRING_CORE_IMPLEMENTATION(mc3, int);
+MPMCRING_CORE_INTERFACE(mc2, int, extern);
+MPMCRING_CORE_IMPLEMENTATION(mc2, int);
+MPMCRING_CORE(mc1, int);
+
+MPMCRING_INTERFACE(ma2, int, extern);
+MPMCRING_IMPLEMENTATION(ma2, int, bbmemory_alloc, free);
+MPMCRING(ma1, int, bbmemory_alloc, free);
+MPMCRING_DEFAULT(md1, int);
+
+/* Deques. */
+
+WSDEQUE_STRUCT(wc3, int);
+WSDEQUE_CORE_DECLARATIONS(wc3, int, extern);
+WSDEQUE_CORE_IMPLEMENTATION(wc3, int);
+WSDEQUE_CORE_INTERFACE(wc2, int, extern);
+WSDEQUE_CORE_IMPLEMENTATION(wc2, int);
+WSDEQUE_CORE(wc1, int);
+
+WSDEQUE_INTERFACE(wa2, int, extern);
+WSDEQUE_IMPLEMENTATION(wa2, int, bbmemory_alloc, free);
+WSDEQUE(wa1, int, bbmemory_alloc, free);
+WSDEQUE_DEFAULT(wd1, int *);
+
+/* Segmented vectors. */
+
+SVECTOR_STRUCT(sv3, int);
+SVECTOR_DECLARATIONS(sv3, int, extern);
+SVECTOR_IMPLEMENTATION(sv3, int, bbmemory_alloc, free);
+SVECTOR_INTERFACE(sv2, int, extern);
+SVECTOR_IMPLEMENTATION(sv2, int, bbmemory_alloc, free);
+SVECTOR(sv1, int, bbmemory_alloc, free);
+SVECTOR_DEFAULT(svd1, const char *);
+
 /* Legacy. */
 
 BBDECLARE_BVECTOR(bpub, int, extern);